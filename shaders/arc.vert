@@ -1,10 +1,24 @@
 #version 300 es
 precision highp float;
 
+// Either a position, or (turn fraction clockwise from 12 o'clock, radius
+// fraction) when u_polar is set
 layout(location = 0) in vec2 a_position;
 
-uniform mat4 u_projection;
+// FrameGlobals (u_projection, ...) is declared in frame_globals.glsl
+
+uniform bool u_polar;
+uniform float u_radiusScale;
+
+const float PI = 3.14159265358979;
+const float TAU = 6.28318530717959;
 
 void main() {
-    gl_Position = u_projection * vec4(a_position, 0.0, 1.0);
+    vec2 position = a_position;
+    if (u_polar) {
+        float angle = PI / 2.0 - a_position.x * TAU;
+        float radius = a_position.y * u_radiusScale;
+        position = radius * vec2(cos(angle), sin(angle));
+    }
+    gl_Position = u_projection * vec4(position, 0.0, 1.0);
 }
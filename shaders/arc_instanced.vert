@@ -0,0 +1,57 @@
+#version 300 es
+precision highp float;
+
+layout(location = 0) in vec3 a_segment;  // (zone, t, side): zone 0 = start cap, 1 = body, 2 = end cap
+layout(location = 1) in vec3 a_arc;      // Per instance: (inner radius, outer radius, sweep fraction)
+layout(location = 2) in vec3 a_color;    // Per instance: RGB
+
+// FrameGlobals (u_projection, ...) is declared in frame_globals.glsl
+
+out vec3 v_color;
+
+const float PI = 3.14159265358979;
+const float TAU = 6.28318530717959;
+
+void main() {
+    float innerRadius = a_arc.x;
+    float outerRadius = a_arc.y;
+    float cr = (outerRadius - innerRadius) * 0.1;
+
+    // Same layout as ArcRenderer::generateArcGeometry: start at 12 o'clock, sweep clockwise
+    float arcStart = PI / 2.0;
+    float sweep = a_arc.z * TAU;
+    float endcapSize = atan(cr / innerRadius);
+    float mainStart = arcStart - endcapSize;
+    float mainSweep = sweep - endcapSize * 2.0;
+
+    float zone = a_segment.x;
+    float t = a_segment.y;
+
+    float angle;
+    float edgeDist;  // Angular distance from the nearest arc edge (caps only)
+    if (zone < 0.5) {
+        angle = arcStart - t * endcapSize;
+        edgeDist = t * endcapSize;
+    } else if (zone < 1.5) {
+        angle = mainStart - t * mainSweep;
+        edgeDist = endcapSize;
+    } else {
+        angle = mainStart - mainSweep - t * endcapSize;
+        edgeDist = (1.0 - t) * endcapSize;
+    }
+
+    // Rounded corner profile from the circle equation, as in generateEndcap
+    float radius;
+    if (zone > 0.5 && zone < 1.5) {
+        radius = mix(innerRadius, outerRadius, a_segment.z);
+    } else {
+        float outerDist = outerRadius * edgeDist - cr;
+        float innerDist = innerRadius * edgeDist - cr;
+        float outer = outerRadius - cr + sqrt(max(cr * cr - outerDist * innerDist, 0.0));
+        float inner = innerRadius + cr - sqrt(max(cr * cr - innerDist * innerDist, 0.0));
+        radius = mix(inner, outer, a_segment.z);
+    }
+
+    v_color = a_color;
+    gl_Position = u_projection * vec4(radius * cos(angle), radius * sin(angle), 0.0, 1.0);
+}
@@ -0,0 +1,42 @@
+#version 300 es
+precision highp float;
+
+in vec2 v_local;
+
+uniform vec3 u_colorBase;
+uniform float u_innerRadius;
+uniform float u_outerRadius;
+uniform float u_sweep;         // Arc sweep in radians, clockwise from 12 o'clock
+uniform float u_cornerRadius;
+
+out vec4 fragColor;
+
+// Signed distance to a wedge of half-angle h centered on +y (negative inside).
+float sdWedge(vec2 p, float h) {
+    vec2 c = vec2(sin(h), cos(h));
+    p.x = abs(p.x);
+    float m = length(p - c * max(dot(p, c), 0.0));
+    return m * sign(c.y * p.x - c.x * p.y);
+}
+
+void main() {
+    // Rotate so the sector is symmetric about +y
+    float h = 0.5 * u_sweep;
+    float c = cos(h);
+    float s = sin(h);
+    vec2 p = vec2(c * v_local.x - s * v_local.y, s * v_local.x + c * v_local.y);
+
+    // Shrink the annulus and wedge by the corner radius, then grow the
+    // intersection back out by the same amount to round all four corners
+    float cr = u_cornerRadius;
+    float mid = 0.5 * (u_innerRadius + u_outerRadius);
+    float halfThickness = 0.5 * (u_outerRadius - u_innerRadius);
+    vec2 q = vec2(abs(length(p) - mid) - (halfThickness - cr),
+                  sdWedge(p, h) + cr);
+    float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - cr;
+
+    // One pixel wide antialiased edge
+    float aa = max(fwidth(d), 1e-6);
+    float alpha = clamp(0.5 - d / aa, 0.0, 1.0);
+    fragColor = vec4(u_colorBase, alpha);
+}
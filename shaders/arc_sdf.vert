@@ -0,0 +1,15 @@
+#version 300 es
+precision highp float;
+
+layout(location = 0) in vec2 a_position;  // Unit quad corner in [-1, 1]
+
+// FrameGlobals (u_projection, ...) is declared in frame_globals.glsl
+
+uniform float u_extent;  // Half-size of the bounding quad
+
+out vec2 v_local;
+
+void main() {
+    v_local = a_position * u_extent;
+    gl_Position = u_projection * vec4(v_local, 0.0, 1.0);
+}
@@ -0,0 +1,12 @@
+// Per-frame values shared by every program, mirroring FrameGlobals::Block in
+// src/frame_globals.h. Shader::submit inserts this after the #version line of
+// every vertex shader, and checks when the program links that the block is
+// no larger than the C++ struct.
+layout(std140) uniform FrameGlobals {
+    mat4 u_projection;
+    vec4 u_viewport;     // (width, height, 1 / width, 1 / height) in pixels
+    float u_time;        // Seconds since the renderer started
+    float u_pixelScale;  // Framebuffer pixels per world unit
+    float u_dpiScale;    // Framebuffer pixels per logical pixel
+    float u_pad;         // Block::pad; unused
+};
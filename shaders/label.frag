@@ -0,0 +1,15 @@
+#version 300 es
+precision highp float;
+precision mediump sampler2DArray;
+
+in vec3 v_texCoord;
+in vec4 v_color;
+
+uniform sampler2DArray u_labels;  // Label coverage, one layer per label
+
+out vec4 fragColor;
+
+void main() {
+    float coverage = texture(u_labels, v_texCoord).r;
+    fragColor = vec4(v_color.rgb, coverage * v_color.a);
+}
@@ -0,0 +1,17 @@
+#version 300 es
+precision highp float;
+
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in vec3 a_texCoord;  // Slice UV and layer
+layout(location = 2) in vec4 a_color;
+
+// FrameGlobals (u_projection, ...) is declared in frame_globals.glsl
+
+out vec3 v_texCoord;
+out vec4 v_color;
+
+void main() {
+    v_texCoord = a_texCoord;
+    v_color = a_color;
+    gl_Position = u_projection * vec4(a_position, 0.0, 1.0);
+}
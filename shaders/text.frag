@@ -1,17 +1,25 @@
 #version 300 es
 precision highp float;
+precision mediump sampler2DArray;
 
-in vec2 v_texCoord;
+in vec3 v_texCoord;  // Atlas UV and page
+in vec4 v_color;
 
-uniform sampler2D u_fontTexture;
-uniform vec3 u_textColor;
-uniform float u_alpha;
+uniform sampler2DArray u_fontTexture;
+uniform bool u_sdf;  // Atlas holds signed distances (0.5 on the outline) instead of coverage
 
 out vec4 fragColor;
 
 void main() {
-    float alpha = texture(u_fontTexture, v_texCoord).r;
-    // Slightly boost contrast to reduce halo while preserving antialiasing
-    alpha = smoothstep(0.0, 0.5, alpha);
-    fragColor = vec4(u_textColor, alpha * u_alpha);
+    float texel = texture(u_fontTexture, v_texCoord).r;
+    float alpha;
+    if (u_sdf) {
+        // Antialias over one screen pixel around the outline at any scale
+        float w = fwidth(texel);
+        alpha = smoothstep(0.5 - w, 0.5 + w, texel);
+    } else {
+        // Slightly boost contrast to reduce halo while preserving antialiasing
+        alpha = smoothstep(0.0, 0.5, texel);
+    }
+    fragColor = vec4(v_color.rgb, alpha * v_color.a);
 }
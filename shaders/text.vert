@@ -2,14 +2,16 @@
 precision highp float;
 
 layout(location = 0) in vec2 a_position;
-layout(location = 1) in vec2 a_texCoord;
+layout(location = 1) in vec3 a_texCoord;  // Atlas UV and page
+layout(location = 2) in vec4 a_color;
 
-uniform mat4 u_projection;
-uniform mat4 u_model;
+// FrameGlobals (u_projection, ...) is declared in frame_globals.glsl
 
-out vec2 v_texCoord;
+out vec3 v_texCoord;
+out vec4 v_color;
 
 void main() {
     v_texCoord = a_texCoord;
-    gl_Position = u_projection * u_model * vec4(a_position, 0.0, 1.0);
+    v_color = a_color;
+    gl_Position = u_projection * vec4(a_position, 0.0, 1.0);
 }
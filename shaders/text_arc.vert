@@ -0,0 +1,54 @@
+#version 300 es
+precision highp float;
+
+#define MAX_ARC_STRINGS 32
+#define GLYPH_TABLE_SIZE 256
+
+layout(location = 0) in vec2 a_corner;  // Unit quad corner: (0, 0) bottom-left to (1, 1) top-right
+layout(location = 1) in vec3 a_glyph;   // Per instance: (glyph table slot, advance before glyph, string index)
+
+// FrameGlobals (u_projection, ...) is declared in frame_globals.glsl
+
+uniform float u_baseline;                     // Baseline offset from the arc, in font pixels
+uniform vec4 u_strings[MAX_ARC_STRINGS * 2];  // Per string: (radius, start angle, scale, direction), RGBA
+
+layout(std140) uniform GlyphTable {
+    vec4 u_glyphUv[GLYPH_TABLE_SIZE];           // Atlas rect (x0, y0, x1, y1), y0 at the glyph top
+    vec4 u_glyphBox[GLYPH_TABLE_SIZE];          // (left of center, yoff, width, height) in font pixels
+    vec4 u_glyphAdvance[GLYPH_TABLE_SIZE / 4];  // xadvance, four glyphs per vec4
+    vec4 u_glyphPage[GLYPH_TABLE_SIZE / 4];     // Atlas page, four glyphs per vec4
+};
+
+out vec3 v_texCoord;
+out vec4 v_color;
+
+void main() {
+    int glyph = int(a_glyph.x);
+    int str = int(a_glyph.z);
+    vec4 params = u_strings[str * 2];
+    float radius = params.x;
+    float scale = params.z;
+    float dir = params.w;
+
+    vec4 uv = u_glyphUv[glyph];
+    vec4 box = u_glyphBox[glyph];
+    float advance = u_glyphAdvance[glyph / 4][glyph % 4];
+    float page = u_glyphPage[glyph / 4][glyph % 4];
+
+    // Angle at the center of this glyph's advance along the arc
+    float angle = params.y + dir * (a_glyph.y + advance * 0.5) * scale / radius;
+    vec2 radial = vec2(cos(angle), sin(angle));
+
+    // Tangent to the arc: angle - PI/2 for clockwise text, angle + PI/2 otherwise
+    vec2 axisX = dir < 0.0 ? vec2(radial.y, -radial.x) : vec2(-radial.y, radial.x);
+    vec2 axisY = vec2(-axisX.y, axisX.x);
+
+    // Glyph quad centered horizontally on its arc position
+    vec2 local = vec2(box.x, u_baseline - box.y - box.w) + a_corner * box.zw;
+    vec2 pos = radius * radial + (axisX * local.x + axisY * local.y) * scale;
+
+    // Texture y0 is the top of the glyph
+    v_texCoord = vec3(mix(uv.x, uv.z, a_corner.x), mix(uv.w, uv.y, a_corner.y), page);
+    v_color = u_strings[str * 2 + 1];
+    gl_Position = u_projection * vec4(pos, 0.0, 1.0);
+}
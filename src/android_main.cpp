@@ -3,9 +3,11 @@
 #include <android_native_app_glue.h>
 #include <android/log.h>
 #include <chrono>
+#include <string>
 
 #include "platform/android_platform.h"
 #include "renderer.h"
+#include "program_cache.h"
 #include "polar_clock.h"
 
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "PolarClock", __VA_ARGS__)
@@ -35,13 +37,22 @@ static void initRenderer() {
     int width, height;
     g_platform->getFramebufferSize(width, height);
 
+    std::string cacheDirectory = g_platform->getCacheDirectory();
+    if (!cacheDirectory.empty()) {
+        polarclock::ProgramCache::instance().setDirectory(cacheDirectory + "/programs");
+    }
+
+    auto initStart = std::chrono::high_resolution_clock::now();
     if (g_renderer->init(width, height)) {
         g_rendererInitialized = true;
         g_lastWidth = width;
         g_lastHeight = height;
         g_lastTime = std::chrono::high_resolution_clock::now();
         g_firstFrame = true;
-        LOGI("Renderer initialized: %dx%d", width, height);
+        const polarclock::ProgramCache& cache = polarclock::ProgramCache::instance();
+        LOGI("Renderer initialized: %dx%d in %.1f ms (%d programs from cache, %d compiled)", width, height,
+             std::chrono::duration<double, std::milli>(g_lastTime - initStart).count(),
+             cache.getHits(), cache.getMisses());
     } else {
         LOGE("Failed to initialize renderer");
         delete g_renderer;
@@ -149,10 +160,15 @@ static void renderFrame() {
         LOGI("Resized to %dx%d", newWidth, newHeight);
     }
 
+    g_renderer->setContentScale(g_platform->getContentScale());
+
     // Update and render
     g_clock->update(deltaTime);
     g_renderer->render(*g_clock);
     g_platform->swapBuffers();
+
+    // Sleep in ALooper_pollAll until the clock next visibly changes
+    g_platform->setFrameDelay(g_renderer->getTimeUntilChange(*g_clock));
 }
 
 void android_main(struct android_app* app) {
@@ -175,8 +191,9 @@ void android_main(struct android_app* app) {
         int events;
         struct android_poll_source* source;
 
-        // Block while paused (timeout = -1), poll otherwise (timeout = 0)
-        int timeout = (g_platform->isPaused() || !g_platform->hasValidSurface()) ? -1 : 0;
+        // Block while paused (timeout = -1), otherwise until the next frame is due
+        int timeout = (g_platform->isPaused() || !g_platform->hasValidSurface())
+            ? -1 : g_platform->getPollTimeout();
 
         while (ALooper_pollAll(timeout, nullptr, &events, reinterpret_cast<void**>(&source)) >= 0) {
             if (source) {
@@ -188,7 +205,8 @@ void android_main(struct android_app* app) {
             }
 
             // After processing events, check if we should continue blocking
-            timeout = (g_platform->isPaused() || !g_platform->hasValidSurface()) ? -1 : 0;
+            timeout = (g_platform->isPaused() || !g_platform->hasValidSurface())
+                ? -1 : g_platform->getPollTimeout();
         }
 
         // Render frame if not paused and surface is valid
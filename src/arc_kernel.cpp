@@ -0,0 +1,445 @@
+#include "arc_kernel.h"
+#include "pcmath.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#if defined(POLARCLOCK_ARC_KERNEL_SCALAR)
+// Scalar fallback forced, e.g. to test it on a machine with SIMD
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define ARC_KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ARC_KERNEL_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ARC_KERNEL_NEON
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define ARC_KERNEL_WASM
+#endif
+
+namespace polarclock {
+
+using namespace math::sincos_poly;
+
+static void polarToCartesianScalar(const PolarVertex* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float s, c;
+        math::fastSinCos(in[i].angle, s, c);
+        out[2 * i] = in[i].radius * c;
+        out[2 * i + 1] = in[i].radius * s;
+    }
+}
+
+#if defined(ARC_KERNEL_AVX2)
+
+static inline void sinCos8(__m256 x, __m256& s, __m256& c) {
+    __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI)));
+    __m256 k = _mm256_cvtepi32_ps(q);
+    __m256 r = _mm256_fnmadd_ps(k, _mm256_set1_ps(PIO2_1), x);
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(PIO2_2), r);
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(PIO2_3), r);
+    __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 ps = _mm256_fmadd_ps(r2, _mm256_set1_ps(SIN_C3), _mm256_set1_ps(SIN_C2));
+    ps = _mm256_fmadd_ps(r2, ps, _mm256_set1_ps(SIN_C1));
+    ps = _mm256_fmadd_ps(_mm256_mul_ps(r2, r), ps, r);
+
+    __m256 pc = _mm256_fmadd_ps(r2, _mm256_set1_ps(COS_C3), _mm256_set1_ps(COS_C2));
+    pc = _mm256_fmadd_ps(r2, pc, _mm256_set1_ps(COS_C1));
+    pc = _mm256_fmadd_ps(_mm256_mul_ps(r2, r2), pc, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), r2, _mm256_set1_ps(1.0f)));
+
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+        _mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    __m256 sv = _mm256_blendv_ps(ps, pc, swap);
+    __m256 cv = _mm256_blendv_ps(pc, ps, swap);
+
+    // Move quadrant bit 1 into the float sign bit
+    __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+    s = _mm256_xor_ps(sv, sinSign);
+    c = _mm256_xor_ps(cv, cosSign);
+}
+
+void polarToCartesian(const PolarVertex* in, float* out, size_t count) {
+    const float* src = reinterpret_cast<const float*>(in);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v0 = _mm256_loadu_ps(src + 2 * i);
+        __m256 v1 = _mm256_loadu_ps(src + 2 * i + 8);
+
+        // Deinterleave within 128-bit lanes; the resulting element order
+        // (0 1 4 5 | 2 3 6 7) is undone by the unpacks below
+        __m256 angle = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 radius = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+
+        __m256 s, c;
+        sinCos8(angle, s, c);
+        __m256 x = _mm256_mul_ps(radius, c);
+        __m256 y = _mm256_mul_ps(radius, s);
+
+        _mm256_storeu_ps(out + 2 * i, _mm256_unpacklo_ps(x, y));
+        _mm256_storeu_ps(out + 2 * i + 8, _mm256_unpackhi_ps(x, y));
+    }
+    polarToCartesianScalar(in + i, out + 2 * i, count - i);
+}
+
+const char* arcKernelBackend() { return "avx2"; }
+
+#elif defined(ARC_KERNEL_SSE2)
+
+static inline __m128 select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline void sinCos4(__m128 x, __m128& s, __m128& c) {
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+    __m128 k = _mm_cvtepi32_ps(q);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(PIO2_1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(PIO2_2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(PIO2_3)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(SIN_C3)), _mm_set1_ps(SIN_C2));
+    ps = _mm_add_ps(_mm_mul_ps(r2, ps), _mm_set1_ps(SIN_C1));
+    ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r2, r), ps), r);
+
+    __m128 pc = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(COS_C3)), _mm_set1_ps(COS_C2));
+    pc = _mm_add_ps(_mm_mul_ps(r2, pc), _mm_set1_ps(COS_C1));
+    pc = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r2, r2), pc),
+                    _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)));
+
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(
+        _mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 sv = select4(swap, pc, ps);
+    __m128 cv = select4(swap, ps, pc);
+
+    // Move quadrant bit 1 into the float sign bit
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(
+        _mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+    s = _mm_xor_ps(sv, sinSign);
+    c = _mm_xor_ps(cv, cosSign);
+}
+
+void polarToCartesian(const PolarVertex* in, float* out, size_t count) {
+    const float* src = reinterpret_cast<const float*>(in);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v0 = _mm_loadu_ps(src + 2 * i);
+        __m128 v1 = _mm_loadu_ps(src + 2 * i + 4);
+        __m128 angle = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 radius = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+
+        __m128 s, c;
+        sinCos4(angle, s, c);
+        __m128 x = _mm_mul_ps(radius, c);
+        __m128 y = _mm_mul_ps(radius, s);
+
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(x, y));
+    }
+    polarToCartesianScalar(in + i, out + 2 * i, count - i);
+}
+
+const char* arcKernelBackend() { return "sse2"; }
+
+#elif defined(ARC_KERNEL_NEON)
+
+static inline void sinCos4(float32x4_t x, float32x4_t& s, float32x4_t& c) {
+    // Round half away from zero: add copysign(0.5, y), then truncate
+    float32x4_t y = vmulq_n_f32(x, TWO_OVER_PI);
+    uint32x4_t signBit = vandq_u32(vreinterpretq_u32_f32(y), vdupq_n_u32(0x80000000u));
+    float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(signBit, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+    int32x4_t q = vcvtq_s32_f32(vaddq_f32(y, half));
+
+    float32x4_t k = vcvtq_f32_s32(q);
+    float32x4_t r = vmlsq_n_f32(x, k, PIO2_1);
+    r = vmlsq_n_f32(r, k, PIO2_2);
+    r = vmlsq_n_f32(r, k, PIO2_3);
+    float32x4_t r2 = vmulq_f32(r, r);
+
+    float32x4_t ps = vmlaq_n_f32(vdupq_n_f32(SIN_C2), r2, SIN_C3);
+    ps = vmlaq_f32(vdupq_n_f32(SIN_C1), r2, ps);
+    ps = vmlaq_f32(r, vmulq_f32(r2, r), ps);
+
+    float32x4_t pc = vmlaq_n_f32(vdupq_n_f32(COS_C2), r2, COS_C3);
+    pc = vmlaq_f32(vdupq_n_f32(COS_C1), r2, pc);
+    pc = vmlaq_f32(vmlsq_n_f32(vdupq_n_f32(1.0f), r2, 0.5f), vmulq_f32(r2, r2), pc);
+
+    uint32x4_t swap = vtstq_s32(q, vdupq_n_s32(1));
+    float32x4_t sv = vbslq_f32(swap, pc, ps);
+    float32x4_t cv = vbslq_f32(swap, ps, pc);
+
+    // Move quadrant bit 1 into the float sign bit
+    uint32x4_t sinSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(q, vdupq_n_s32(2))), 30);
+    uint32x4_t cosSign = vshlq_n_u32(vreinterpretq_u32_s32(
+        vandq_s32(vaddq_s32(q, vdupq_n_s32(1)), vdupq_n_s32(2))), 30);
+    s = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sv), sinSign));
+    c = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cv), cosSign));
+}
+
+void polarToCartesian(const PolarVertex* in, float* out, size_t count) {
+    const float* src = reinterpret_cast<const float*>(in);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // vld2/vst2 deinterleave and reinterleave the (angle, radius) pairs
+        float32x4x2_t v = vld2q_f32(src + 2 * i);
+
+        float32x4_t s, c;
+        sinCos4(v.val[0], s, c);
+
+        float32x4x2_t xy;
+        xy.val[0] = vmulq_f32(v.val[1], c);
+        xy.val[1] = vmulq_f32(v.val[1], s);
+        vst2q_f32(out + 2 * i, xy);
+    }
+    polarToCartesianScalar(in + i, out + 2 * i, count - i);
+}
+
+const char* arcKernelBackend() { return "neon"; }
+
+#elif defined(ARC_KERNEL_WASM)
+
+static inline void sinCos4(v128_t x, v128_t& s, v128_t& c) {
+    v128_t q = wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_nearest(wasm_f32x4_mul(x, wasm_f32x4_splat(TWO_OVER_PI))));
+    v128_t k = wasm_f32x4_convert_i32x4(q);
+    v128_t r = wasm_f32x4_sub(x, wasm_f32x4_mul(k, wasm_f32x4_splat(PIO2_1)));
+    r = wasm_f32x4_sub(r, wasm_f32x4_mul(k, wasm_f32x4_splat(PIO2_2)));
+    r = wasm_f32x4_sub(r, wasm_f32x4_mul(k, wasm_f32x4_splat(PIO2_3)));
+    v128_t r2 = wasm_f32x4_mul(r, r);
+
+    v128_t ps = wasm_f32x4_add(wasm_f32x4_mul(r2, wasm_f32x4_splat(SIN_C3)), wasm_f32x4_splat(SIN_C2));
+    ps = wasm_f32x4_add(wasm_f32x4_mul(r2, ps), wasm_f32x4_splat(SIN_C1));
+    ps = wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_mul(r2, r), ps), r);
+
+    v128_t pc = wasm_f32x4_add(wasm_f32x4_mul(r2, wasm_f32x4_splat(COS_C3)), wasm_f32x4_splat(COS_C2));
+    pc = wasm_f32x4_add(wasm_f32x4_mul(r2, pc), wasm_f32x4_splat(COS_C1));
+    pc = wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_mul(r2, r2), pc),
+                        wasm_f32x4_sub(wasm_f32x4_splat(1.0f), wasm_f32x4_mul(wasm_f32x4_splat(0.5f), r2)));
+
+    v128_t swap = wasm_i32x4_eq(wasm_v128_and(q, wasm_i32x4_splat(1)), wasm_i32x4_splat(1));
+    v128_t sv = wasm_v128_bitselect(pc, ps, swap);
+    v128_t cv = wasm_v128_bitselect(ps, pc, swap);
+
+    // Move quadrant bit 1 into the float sign bit
+    v128_t sinSign = wasm_i32x4_shl(wasm_v128_and(q, wasm_i32x4_splat(2)), 30);
+    v128_t cosSign = wasm_i32x4_shl(wasm_v128_and(wasm_i32x4_add(q, wasm_i32x4_splat(1)), wasm_i32x4_splat(2)), 30);
+    s = wasm_v128_xor(sv, sinSign);
+    c = wasm_v128_xor(cv, cosSign);
+}
+
+void polarToCartesian(const PolarVertex* in, float* out, size_t count) {
+    const float* src = reinterpret_cast<const float*>(in);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        v128_t v0 = wasm_v128_load(src + 2 * i);
+        v128_t v1 = wasm_v128_load(src + 2 * i + 4);
+        v128_t angle = wasm_i32x4_shuffle(v0, v1, 0, 2, 4, 6);
+        v128_t radius = wasm_i32x4_shuffle(v0, v1, 1, 3, 5, 7);
+
+        v128_t s, c;
+        sinCos4(angle, s, c);
+        v128_t x = wasm_f32x4_mul(radius, c);
+        v128_t y = wasm_f32x4_mul(radius, s);
+
+        wasm_v128_store(out + 2 * i, wasm_i32x4_shuffle(x, y, 0, 4, 1, 5));
+        wasm_v128_store(out + 2 * i + 4, wasm_i32x4_shuffle(x, y, 2, 6, 3, 7));
+    }
+    polarToCartesianScalar(in + i, out + 2 * i, count - i);
+}
+
+const char* arcKernelBackend() { return "wasm-simd128"; }
+
+#else
+
+void polarToCartesian(const PolarVertex* in, float* out, size_t count) {
+    polarToCartesianScalar(in, out, count);
+}
+
+const char* arcKernelBackend() { return "scalar"; }
+
+#endif
+
+/**
+ * @brief Append one arc edge (inner and outer vertex at the same angle).
+ *
+ * Arc meshes are triangle strips that alternate inner and outer vertices, so
+ * every edge is shared by the quads on either side of it.
+ *
+ * @param vertices Output polar vertex buffer to append to.
+ * @param angle    Angle of the edge (radians).
+ * @param inner    Inner radius at this angle.
+ * @param outer    Outer radius at this angle.
+ */
+static void pushEdge(std::vector<PolarVertex>& vertices, double angle, double inner, double outer) {
+    vertices.push_back({ static_cast<float>(angle), static_cast<float>(inner) });
+    vertices.push_back({ static_cast<float>(angle), static_cast<float>(outer) });
+}
+
+/**
+ * @brief Generate rounded endcap edges for an arc.
+ *
+ * Creates the rounded corner effect at the start or end of an arc using the
+ * circle equation to calculate the inner/outer edge positions at each angle.
+ *
+ * The algorithm works by:
+ * 1. Sweeping through the endcap angular region in small steps.
+ * 2. For each step, calculating the arc-length distance from the arc's edge.
+ * 3. Using the circle equation (x² + y² = r²) to determine how far the inner/outer
+ *    edges should be inset to create the rounded corner effect.
+ *
+ * The circle equation is solved for y given x:
+ *   y = sqrt(r² - x²)
+ *
+ * This gives the offset from the corner center, which is then applied to create
+ * the rounded edge profile.
+ *
+ * Edge i sits at endcapStart - (i / numSegments) * endcapSize. Only edges
+ * [firstEdge, lastEdge] are emitted so that the edge shared with the body is
+ * not duplicated.
+ *
+ * @param vertices       Output polar vertex buffer to append to.
+ * @param innerRadius    Inner radius of the arc ring.
+ * @param outerRadius    Outer radius of the arc ring.
+ * @param cr             Corner radius for the rounded effect.
+ * @param endcapStart    Starting angle of the endcap region (radians).
+ * @param endcapSize     Angular size of the endcap region (radians).
+ * @param referenceAngle The angle of the arc's edge (used to calculate distances).
+ * @param numSegments    Number of steps to sweep the endcap region with.
+ * @param firstEdge      First edge index to emit.
+ * @param lastEdge       Last edge index to emit (inclusive).
+ */
+void generateEndcap(std::vector<PolarVertex>& vertices,
+                    double innerRadius, double outerRadius, double cr,
+                    double endcapStart, double endcapSize, double referenceAngle,
+                    int numSegments, int firstEdge, int lastEdge) {
+    for (int i = firstEdge; i <= lastEdge; ++i) {
+        double t = static_cast<double>(i) / numSegments;
+        double a = endcapStart - t * endcapSize;
+
+        // Calculate arc-length distance from the reference angle (arc edge)
+        // This represents the "x" value in our circle equation
+        double outerDist = outerRadius * std::abs(referenceAngle - a) - cr;
+        double innerDist = innerRadius * std::abs(referenceAngle - a) - cr;
+
+        // Apply circle equation: y = sqrt(r² - x²) to find edge offset
+        // For outer edge: radius decreases (inset toward center)
+        // For inner edge: radius increases (inset away from center)
+        double outer = outerRadius - cr + std::sqrt(std::max(cr * cr - outerDist * innerDist, 0.0));
+        double inner = innerRadius + cr - std::sqrt(std::max(cr * cr - innerDist * innerDist, 0.0));
+
+        pushEdge(vertices, a, inner, outer);
+    }
+}
+
+ArcLayout computeArcLayout(double innerRadius, double outerRadius, double endAngle,
+                           int circleSegments) {
+    ArcLayout layout;
+
+    double ringThickness = outerRadius - innerRadius;
+    layout.cr = ringThickness * 0.1;  // Corner radius (20% of thickness)
+
+    layout.arcStart = math::PI / 2.0;  // 12 o'clock
+    double sweep = endAngle * math::TAU;
+    layout.arcEnd = layout.arcStart - sweep;
+
+    // Calculate angular size of endcaps using tangent offset
+    layout.endcapSize = std::atan(layout.cr / innerRadius);
+
+    // Main arc body runs between the two endcap regions
+    layout.mainStart = layout.arcStart - layout.endcapSize;
+    layout.mainSweep = sweep - layout.endcapSize * 2.0;
+
+    layout.step = math::TAU / circleSegments;
+    layout.fullSegments = layout.mainSweep > 0.0
+        ? static_cast<int>(layout.mainSweep / layout.step)
+        : 0;
+
+    return layout;
+}
+
+/**
+ * @brief Append the rounded corners at the arc's starting edge.
+ *
+ * The last endcap edge coincides with the first body edge, so it is left out.
+ */
+void appendStartCap(std::vector<PolarVertex>& vertices, double innerRadius, double outerRadius,
+                    const ArcLayout& layout, int endcapSegments) {
+    generateEndcap(vertices, innerRadius, outerRadius, layout.cr,
+                   layout.arcStart, layout.endcapSize, layout.arcStart,
+                   endcapSegments, 0, endcapSegments - 1);
+}
+
+/**
+ * @brief Append body edges [firstEdge, layout.fullSegments].
+ *
+ * Edge i is the boundary between full segments i - 1 and i.
+ */
+void appendBody(std::vector<PolarVertex>& vertices, double innerRadius, double outerRadius,
+                const ArcLayout& layout, int firstEdge) {
+    for (int i = firstEdge; i <= layout.fullSegments; ++i) {
+        pushEdge(vertices, layout.mainStart - i * layout.step, innerRadius, outerRadius);
+    }
+}
+
+/**
+ * @brief Append the partial tail segment and the rounded corners at the arc's end.
+ *
+ * This is the only part of the mesh that moves as the sweep grows.
+ */
+void appendTail(std::vector<PolarVertex>& vertices, double innerRadius, double outerRadius,
+                const ArcLayout& layout, int endcapSegments) {
+    double mainEnd = layout.mainStart - layout.mainSweep;
+    double tailStart = layout.mainStart - layout.fullSegments * layout.step;
+
+    if (std::abs(tailStart - mainEnd) > 1e-9) {
+        pushEdge(vertices, mainEnd, innerRadius, outerRadius);
+    }
+
+    // The first endcap edge coincides with the tail edge, so it is left out
+    generateEndcap(vertices, innerRadius, outerRadius, layout.cr,
+                   mainEnd, layout.endcapSize, layout.arcEnd,
+                   endcapSegments, 1, endcapSegments);
+}
+
+/**
+ * @brief Generate complete arc geometry including rounded corners.
+ *
+ * Creates the polar vertex data for an arc segment with rounded corners at
+ * all four corners, as one triangle strip. The arc starts at 12 o'clock and
+ * sweeps clockwise.
+ *
+ * The geometry is composed of three parts, in vertex order:
+ * 1. Start endcap - rounded corners at the arc's starting edge
+ * 2. Main body - the rectangular portion of the arc (full segments, then a
+ *    partial tail segment)
+ * 3. End endcap - rounded corners at the arc's ending edge
+ *
+ * The corner radius is calculated as 20% of the ring thickness, creating
+ * a subtle rounded rectangle appearance.
+ *
+ * @param innerRadius Inner radius of the arc ring.
+ * @param outerRadius Outer radius of the arc ring.
+ * @param endAngle       Arc sweep as a fraction of a full circle (0.0 to 1.0).
+ * @param circleSegments Body segments per full circle.
+ * @param endcapSegments Segments per rounded endcap.
+ * @param vertices    Output buffer to fill with polar vertex data (cleared first).
+ */
+void generateArcGeometry(double innerRadius, double outerRadius, double endAngle,
+                         int circleSegments, int endcapSegments, std::vector<PolarVertex>& vertices) {
+    vertices.clear();
+
+    if (endAngle <= 0.001f) return;
+
+    ArcLayout layout = computeArcLayout(innerRadius, outerRadius, endAngle, circleSegments);
+
+    appendStartCap(vertices, innerRadius, outerRadius, layout, endcapSegments);
+    appendBody(vertices, innerRadius, outerRadius, layout, 0);
+    appendTail(vertices, innerRadius, outerRadius, layout, endcapSegments);
+}
+
+} // namespace polarclock
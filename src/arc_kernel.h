@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace polarclock {
+
+// Arc mesh vertex before encoding: angle (radians) and radius
+struct PolarVertex {
+    float angle;
+    float radius;
+};
+
+/**
+ * @brief Convert polar arc vertices to interleaved float2 positions.
+ *
+ * out[2i] = radius_i * cos(angle_i), out[2i + 1] = radius_i * sin(angle_i).
+ *
+ * Several vertices are processed at a time with the polynomial sincos from
+ * pcmath (math::fastSinCos), so all backends agree to within rounding. The
+ * backend is chosen at compile time: AVX2 (8 wide, when built with -mavx2
+ * -mfma), SSE2 (4 wide, any x86-64), NEON (4 wide, Android) or wasm simd128
+ * (4 wide, Emscripten with -msimd128), with a scalar fallback elsewhere or
+ * when POLARCLOCK_ARC_KERNEL_SCALAR is defined.
+ *
+ * @param in    Polar vertices.
+ * @param out   Output positions (2 * count floats).
+ * @param count Number of vertices.
+ */
+void polarToCartesian(const PolarVertex* in, float* out, size_t count);
+
+/**
+ * @brief Name of the compiled-in backend, for logging.
+ */
+const char* arcKernelBackend();
+
+/**
+ * @brief Angular layout of an arc, shared by full and incremental builds.
+ *
+ * The body is split into full segments of a fixed angular step measured from
+ * mainStart, followed by one partial tail segment. Because the full segments
+ * do not depend on the sweep, a growing arc only ever changes its tail and
+ * end cap.
+ */
+struct ArcLayout {
+    double cr;            // Corner radius
+    double arcStart;      // 12 o'clock
+    double arcEnd;
+    double endcapSize;    // Angular size of each endcap region
+    double mainStart;     // Body start (after the start endcap)
+    double mainSweep;     // Body sweep (between the endcaps)
+    double step;          // Angular size of a full body segment
+    int fullSegments;     // Number of full body segments
+};
+
+ArcLayout computeArcLayout(double innerRadius, double outerRadius, double endAngle,
+                           int circleSegments);
+
+// Append endcap edges [firstEdge, lastEdge] of numSegments, sweeping from
+// endcapStart and rounded relative to the arc edge at referenceAngle
+void generateEndcap(std::vector<PolarVertex>& vertices,
+                    double innerRadius, double outerRadius, double cr,
+                    double endcapStart, double endcapSize, double referenceAngle,
+                    int numSegments, int firstEdge, int lastEdge);
+
+// The three parts of an arc's triangle strip, in vertex order
+void appendStartCap(std::vector<PolarVertex>& vertices, double innerRadius, double outerRadius,
+                    const ArcLayout& layout, int endcapSegments);
+void appendBody(std::vector<PolarVertex>& vertices, double innerRadius, double outerRadius,
+                const ArcLayout& layout, int firstEdge);
+void appendTail(std::vector<PolarVertex>& vertices, double innerRadius, double outerRadius,
+                const ArcLayout& layout, int endcapSegments);
+
+// Whole arc (start cap, body, tail) as one strip; vertices is cleared first
+void generateArcGeometry(double innerRadius, double outerRadius, double endAngle,
+                         int circleSegments, int endcapSegments, std::vector<PolarVertex>& vertices);
+
+} // namespace polarclock
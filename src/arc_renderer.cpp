@@ -1,250 +1,513 @@
 #include "arc_renderer.h"
+#include "gl_state.h"
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 namespace polarclock {
 
 ArcRenderer::ArcRenderer()
-    : m_vao(0)
-    , m_vbo(0)
+    : m_stream(nullptr)
+    , m_vao(0)
+    , m_quadVao(0)
+    , m_quadVbo(0)
+    , m_instancedVao(0)
+    , m_unitMeshVbo(0)
+    , m_unitMeshVertexCount(0)
+    , m_mode(ArcRenderMode::Mesh)
+    , m_compactVertices(false)
+    , m_pixelScale(400.0f)
 {
 }
 
 ArcRenderer::~ArcRenderer() {
-    if (m_vao) glDeleteVertexArrays(1, &m_vao);
-    if (m_vbo) glDeleteBuffers(1, &m_vbo);
+    if (m_vao) GLState::instance().deleteVertexArray(m_vao);
+    if (m_quadVao) GLState::instance().deleteVertexArray(m_quadVao);
+    if (m_quadVbo) GLState::instance().deleteBuffer(m_quadVbo);
+    if (m_instancedVao) GLState::instance().deleteVertexArray(m_instancedVao);
+    if (m_unitMeshVbo) GLState::instance().deleteBuffer(m_unitMeshVbo);
+    for (auto& cache : m_meshCache) {
+        if (cache.vao) GLState::instance().deleteVertexArray(cache.vao);
+        if (cache.vbo) GLState::instance().deleteBuffer(cache.vbo);
+    }
 }
 
 /**
  * @brief Initialize OpenGL resources for arc rendering.
  *
- * Loads the arc shader and creates VAO/VBO for dynamic geometry.
- * The vertex format is simple: vec2 position only.
+ * Loads the arc shaders and creates the VAO for dynamic geometry, which
+ * lives in the shared stream buffer. Mesh vertices are either a float2
+ * position or a compact 16-bit polar pair (see encodeVertices); the
+ * attribute format is set at draw time.
+ *
+ * The SDF engine uses a static float2 unit quad, so its buffer is filled
+ * once here and never touched again.
  *
+ * @param stream Shared streaming buffer for per-frame vertex data.
  * @return true if initialization succeeded, false otherwise.
  */
-bool ArcRenderer::init() {
-    if (!m_shader.loadFromFiles("shaders/arc.vert", "shaders/arc.frag")) {
+bool ArcRenderer::init(StreamBuffer& stream) {
+    m_stream = &stream;
+
+    // Submit every arc program up front so the driver can compile them in
+    // parallel; waitForPrograms() collects them
+    if (!m_shader.submitEmbedded(EmbeddedShader::ArcVert, EmbeddedShader::ArcFrag) ||
+        !m_sdfShader.submitEmbedded(EmbeddedShader::ArcSdfVert, EmbeddedShader::ArcSdfFrag) ||
+        !m_instancedShader.submitEmbedded(EmbeddedShader::ArcInstancedVert, EmbeddedShader::ArcInstancedFrag)) {
         return false;
     }
 
     glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    GLState::instance().bindVertexArray(m_vao);
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_stream->getBuffer());
+
+    setVertexFormat(0);
+    glEnableVertexAttribArray(0);
+
+    GLState::instance().bindVertexArray(0);
+
+    // Unit quad as a triangle strip, scaled to the ring's extent in the shader
+    const float quad[] = {
+        -1.0f, -1.0f,
+         1.0f, -1.0f,
+        -1.0f,  1.0f,
+         1.0f,  1.0f
+    };
+
+    glGenVertexArrays(1, &m_quadVao);
+    glGenBuffers(1, &m_quadVbo);
+
+    GLState::instance().bindVertexArray(m_quadVao);
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_quadVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
+    GLState::instance().bindVertexArray(0);
 
-    return true;
+    return initInstanced();
 }
 
 /**
- * @brief Push a quad (two triangles) to the vertex buffer.
- *
- * Creates a quadrilateral segment of an arc by generating two triangles.
- * Each edge of the quad is defined by an inner and outer radius at a given angle.
- *
- * @param vertices Output vertex buffer to append to.
- * @param inner0   Inner radius at the first angle.
- * @param outer0   Outer radius at the first angle.
- * @param c0       Cosine of the first angle.
- * @param s0       Sine of the first angle.
- * @param inner1   Inner radius at the second angle.
- * @param outer1   Outer radius at the second angle.
- * @param c1       Cosine of the second angle.
- * @param s1       Sine of the second angle.
+ * @brief Finish the arc programs the driver is already done with, without
+ * waiting on the rest.
  */
-static void pushQuad(std::vector<float>& vertices,
-                     double inner0, double outer0, double c0, double s0,
-                     double inner1, double outer1, double c1, double s1) {
-    // Triangle 1: inner0 -> outer0 -> inner1
-    vertices.push_back(inner0 * c0);
-    vertices.push_back(inner0 * s0);
-    vertices.push_back(outer0 * c0);
-    vertices.push_back(outer0 * s0);
-    vertices.push_back(inner1 * c1);
-    vertices.push_back(inner1 * s1);
-
-    // Triangle 2: inner1 -> outer0 -> outer1
-    vertices.push_back(inner1 * c1);
-    vertices.push_back(inner1 * s1);
-    vertices.push_back(outer0 * c0);
-    vertices.push_back(outer0 * s0);
-    vertices.push_back(outer1 * c1);
-    vertices.push_back(outer1 * s1);
+void ArcRenderer::pollPrograms() {
+    m_shader.poll();
+    m_sdfShader.poll();
+    m_instancedShader.poll();
 }
 
 /**
- * @brief Generate rounded endcap geometry for an arc.
- *
- * Creates the rounded corner effect at the start or end of an arc using the
- * circle equation to calculate the inner/outer edge positions at each angle.
- *
- * The algorithm works by:
- * 1. Sweeping through the endcap angular region in small segments.
- * 2. For each segment, calculating the arc-length distance from the arc's edge.
- * 3. Using the circle equation (x² + y² = r²) to determine how far the inner/outer
- *    edges should be inset to create the rounded corner effect.
- *
- * The circle equation is solved for y given x:
- *   y = sqrt(r² - x²)
- *
- * This gives the offset from the corner center, which is then applied to create
- * the rounded edge profile.
- *
- * @param vertices       Output vertex buffer to append to.
- * @param innerRadius    Inner radius of the arc ring.
- * @param outerRadius    Outer radius of the arc ring.
- * @param cr             Corner radius for the rounded effect.
- * @param endcapStart    Starting angle of the endcap region (radians).
- * @param endcapSize     Angular size of the endcap region (radians).
- * @param referenceAngle The angle of the arc's edge (used to calculate distances).
+ * @brief Finish the programs submitted by init(), blocking if the driver is
+ * still compiling them, and look up the uniforms set at draw time.
+ *
+ * @return true if all arc programs linked, false otherwise.
  */
-static void generateEndcap(std::vector<float>& vertices,
-                           double innerRadius, double outerRadius, double cr,
-                           double endcapStart, double endcapSize, double referenceAngle) {
-    const int numSegments = 12;
-
-    for (int i = 0; i < numSegments; ++i) {
-        double t0 = static_cast<float>(i) / numSegments;
-        double t1 = static_cast<float>(i + 1) / numSegments;
-
-        double a0 = endcapStart - t0 * endcapSize;
-        double a1 = endcapStart - t1 * endcapSize;
-
-        double c0 = std::cos(a0), s0 = std::sin(a0);
-        double c1 = std::cos(a1), s1 = std::sin(a1);
-
-        // Calculate arc-length distance from the reference angle (arc edge)
-        // This represents the "x" value in our circle equation
-        double a0OuterDist = outerRadius * std::abs(referenceAngle - a0) - cr;
-        double a1OuterDist = outerRadius * std::abs(referenceAngle - a1) - cr;
-        double a0InnerDist = innerRadius * std::abs(referenceAngle - a0) - cr;
-        double a1InnerDist = innerRadius * std::abs(referenceAngle - a1) - cr;
-
-        // Only render if within the corner radius region
-        if (a0InnerDist < cr && a1InnerDist < cr &&
-            a0OuterDist < cr && a1OuterDist < cr) {
-            // Apply circle equation: y = sqrt(r² - x²) to find edge offset
-            // For outer edge: radius decreases (inset toward center)
-            // For inner edge: radius increases (inset away from center)
-            double outer0 = outerRadius - cr + std::sqrt(cr * cr - a0OuterDist * a0InnerDist);
-            double outer1 = outerRadius - cr + std::sqrt(cr * cr - a1OuterDist * a1InnerDist);
-            double inner0 = innerRadius + cr - std::sqrt(cr * cr - a0InnerDist * a0InnerDist);
-            double inner1 = innerRadius + cr - std::sqrt(cr * cr - a1InnerDist * a1InnerDist);
-
-            pushQuad(vertices, inner0, outer0, c0, s0, inner1, outer1, c1, s1);
+bool ArcRenderer::waitForPrograms() {
+    if (!m_shader.wait() || !m_sdfShader.wait() || !m_instancedShader.wait()) {
+        return false;
+    }
+
+    m_meshUniforms.colorBase = m_shader.uniform("u_colorBase");
+    m_meshUniforms.polar = m_shader.uniform("u_polar");
+    m_meshUniforms.radiusScale = m_shader.uniform("u_radiusScale");
+
+    m_sdfUniforms.colorBase = m_sdfShader.uniform("u_colorBase");
+    m_sdfUniforms.innerRadius = m_sdfShader.uniform("u_innerRadius");
+    m_sdfUniforms.outerRadius = m_sdfShader.uniform("u_outerRadius");
+    m_sdfUniforms.sweep = m_sdfShader.uniform("u_sweep");
+    m_sdfUniforms.cornerRadius = m_sdfShader.uniform("u_cornerRadius");
+    m_sdfUniforms.extent = m_sdfShader.uniform("u_extent");
+    return true;
+}
+
+/**
+ * @brief Initialize OpenGL resources for instanced arc rendering.
+ *
+ * Uploads a static unit-segment mesh once. Each vertex is (zone, t, side):
+ * zone selects the start cap, body or end cap, t is the position within that
+ * zone (0 to 1) and side selects the inner or outer edge. The mesh is a single
+ * triangle strip running from the arc start to its end; the angle and rounded
+ * corner math from generateArcGeometry is evaluated per instance in
+ * arc_instanced.vert.
+ *
+ * Per-instance attributes are (inner radius, outer radius, sweep) and color.
+ * They are streamed each frame, so their pointers are set at draw time.
+ *
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool ArcRenderer::initInstanced() {
+    std::vector<float> unitMesh;
+    const int zoneSegments[3] = { ENDCAP_SEGMENTS, SEGMENTS, ENDCAP_SEGMENTS };
+    for (int zone = 0; zone < 3; ++zone) {
+        for (int i = 0; i <= zoneSegments[zone]; ++i) {
+            float t = static_cast<float>(i) / zoneSegments[zone];
+            for (int side = 0; side < 2; ++side) {
+                unitMesh.push_back(static_cast<float>(zone));
+                unitMesh.push_back(t);
+                unitMesh.push_back(static_cast<float>(side));
+            }
         }
     }
+    m_unitMeshVertexCount = static_cast<GLsizei>(unitMesh.size() / 3);
+
+    glGenVertexArrays(1, &m_instancedVao);
+    glGenBuffers(1, &m_unitMeshVbo);
+
+    GLState::instance().bindVertexArray(m_instancedVao);
+
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_unitMeshVbo);
+    glBufferData(GL_ARRAY_BUFFER, unitMesh.size() * sizeof(float), unitMesh.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    GLState::instance().bindVertexArray(0);
+
+    return true;
 }
 
 /**
- * @brief Generate complete arc geometry including rounded corners.
+ * @brief Number of segments needed to sweep an angle within a chord error.
  *
- * Creates the vertex data for an arc segment with rounded corners at all four
- * corners. The arc starts at 12 o'clock and sweeps clockwise.
+ * A chord spanning angle θ on a circle of radius r deviates from the arc by
+ * r * (1 - cos(θ / 2)). Solving for the largest θ that keeps this under the
+ * tolerance gives θ = 2 * acos(1 - tolerance / r).
  *
- * The geometry is composed of three parts:
- * 1. Start endcap - rounded corners at the arc's starting edge
- * 2. Main body - the rectangular portion of the arc
- * 3. End endcap - rounded corners at the arc's ending edge
+ * @param pixelRadius Radius of the curve in pixels.
+ * @param sweep       Angle to cover (radians).
+ * @param tolerance   Maximum allowed chord error in pixels.
+ * @return Segment count (at least 1).
+ */
+static int segmentsForChordError(double pixelRadius, double sweep, double tolerance) {
+    if (pixelRadius <= tolerance) return 1;
+
+    double maxStep = 2.0 * std::acos(1.0 - tolerance / pixelRadius);
+    return std::max(1, static_cast<int>(std::ceil(sweep / maxStep)));
+}
+
+/**
+ * @brief Update the screen scale used for adaptive tessellation.
+ *
+ * Called by Renderer only when the framebuffer size actually changes. All
+ * cached per-ring segment budgets are dropped and lazily recomputed.
+ *
+ * @param pixelsPerUnit Pixels per world unit.
+ */
+void ArcRenderer::setPixelScale(float pixelsPerUnit) {
+    if (pixelsPerUnit == m_pixelScale) return;
+
+    m_pixelScale = pixelsPerUnit;
+    m_segmentBudgets.clear();
+}
+
+/**
+ * @brief Look up (or compute) the tessellation budget for a ring.
+ *
+ * The body density is derived from the projected outer radius, the endcaps
+ * from the projected corner radius, both against MAX_CHORD_ERROR. A small
+ * clock thumbnail therefore emits a fraction of the vertices a full-screen
+ * 4K clock does, while both stay visually smooth.
+ *
+ * @param innerRadius Inner radius of the arc ring.
+ * @param outerRadius Outer radius of the arc ring.
+ * @return The cached budget for this ring.
+ */
+const ArcRenderer::SegmentBudget& ArcRenderer::getSegmentBudget(double innerRadius, double outerRadius) {
+    for (const auto& budget : m_segmentBudgets) {
+        if (budget.innerRadius == innerRadius && budget.outerRadius == outerRadius) {
+            return budget;
+        }
+    }
+
+    double cr = (outerRadius - innerRadius) * 0.1;
+
+    SegmentBudget budget;
+    budget.innerRadius = innerRadius;
+    budget.outerRadius = outerRadius;
+    budget.circleSegments = std::clamp(
+        segmentsForChordError(outerRadius * m_pixelScale, math::TAU, MAX_CHORD_ERROR),
+        MIN_CIRCLE_SEGMENTS, MAX_CIRCLE_SEGMENTS);
+    // Each endcap rounds two quarter-circle corners of radius cr
+    budget.endcapSegments = std::clamp(
+        segmentsForChordError(cr * m_pixelScale, math::PI / 2.0, MAX_CHORD_ERROR),
+        MIN_ENDCAP_SEGMENTS, MAX_ENDCAP_SEGMENTS);
+
+    m_segmentBudgets.push_back(budget);
+    return m_segmentBudgets.back();
+}
+
+/**
+ * @brief Generate complete arc geometry at the ring's screen-space budget.
  *
- * The corner radius is calculated as 20% of the ring thickness, creating
- * a subtle rounded rectangle appearance.
+ * See the free generateArcGeometry in arc_kernel.h for the mesh layout;
+ * segment counts come from getSegmentBudget.
  *
  * @param innerRadius Inner radius of the arc ring.
  * @param outerRadius Outer radius of the arc ring.
  * @param endAngle    Arc sweep as a fraction of a full circle (0.0 to 1.0).
- * @param vertices    Output buffer to fill with vertex data (cleared first).
+ * @param vertices    Output buffer to fill with polar vertex data (cleared first).
  */
 void ArcRenderer::generateArcGeometry(double innerRadius, double outerRadius, double endAngle,
-                                       std::vector<float>& vertices) {
-    vertices.clear();
+                                       std::vector<PolarVertex>& vertices) {
+    // Tessellation density depends on how large this ring appears on screen
+    const SegmentBudget& budget = getSegmentBudget(innerRadius, outerRadius);
+    polarclock::generateArcGeometry(innerRadius, outerRadius, endAngle,
+                                    budget.circleSegments, budget.endcapSegments, vertices);
+}
 
-    if (endAngle <= 0.001f) return;
+/**
+ * @brief Encode polar vertices into the GPU vertex format.
+ *
+ * The full format is a float2 position (8 bytes). The compact format stores
+ * the clockwise angle from 12 o'clock as a fraction of a full turn and the
+ * radius as a fraction of the ring's outer radius, both as normalized 16-bit
+ * integers (4 bytes), and arc.vert expands them. Angular resolution is
+ * TAU / 65535, i.e. under 0.1 pixel of arc length at a 1000 pixel radius.
+ *
+ * @param vertices    Polar vertices to encode.
+ * @param outerRadius Outer radius of the ring (compact radius scale).
+ * @param bytes       Output size of the encoded data in bytes.
+ * @return Pointer to the encoded data, valid until the next call.
+ */
+const void* ArcRenderer::encodeVertices(const std::vector<PolarVertex>& vertices, double outerRadius,
+                                        size_t& bytes) {
+    if (m_compactVertices) {
+        m_compactEncoded.clear();
+        for (const PolarVertex& v : vertices) {
+            float turn = static_cast<float>((math::PI / 2.0 - v.angle) / math::TAU);
+            float radius = static_cast<float>(v.radius / outerRadius);
+            m_compactEncoded.push_back(static_cast<uint16_t>(std::lround(math::clamp(turn, 0.0f, 1.0f) * 65535.0f)));
+            m_compactEncoded.push_back(static_cast<uint16_t>(std::lround(math::clamp(radius, 0.0f, 1.0f) * 65535.0f)));
+        }
+        bytes = m_compactEncoded.size() * sizeof(uint16_t);
+        return m_compactEncoded.data();
+    }
 
-    double ringThickness = outerRadius - innerRadius;
-    double cr = ringThickness * 0.1;  // Corner radius (20% of thickness)
+    m_encoded.resize(vertices.size() * 2);
+    polarToCartesian(vertices.data(), m_encoded.data(), vertices.size());
+    bytes = m_encoded.size() * sizeof(float);
+    return m_encoded.data();
+}
 
-    double arcStart = math::PI / 2.0;  // 12 o'clock
-    double sweep = endAngle * math::TAU;
-    double arcEnd = arcStart - sweep;
+/**
+ * @brief Point attribute 0 of the bound VAO at arc vertices in the current format.
+ */
+void ArcRenderer::setVertexFormat(GLintptr offset) const {
+    if (m_compactVertices) {
+        glVertexAttribPointer(0, 2, GL_UNSIGNED_SHORT, GL_TRUE, 2 * sizeof(uint16_t), (void*)offset);
+    } else {
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)offset);
+    }
+}
 
-    // Calculate angular size of endcaps using tangent offset
-    double endcapAngularSize = std::atan(cr / innerRadius);
+/**
+ * @brief Set arc.vert uniforms describing the vertex format.
+ */
+void ArcRenderer::setVertexFormatUniforms(double outerRadius) {
+    m_shader.setInt(m_meshUniforms.polar, m_compactVertices ? 1 : 0);
+    m_shader.setFloat(m_meshUniforms.radiusScale, static_cast<float>(outerRadius));
+}
 
-    // Main arc body runs between the two endcap regions
-    double mainStart = arcStart - endcapAngularSize;
-    double mainSweep = sweep - endcapAngularSize * 2.0;
+/**
+ * @brief Bring a ring's cached mesh up to date with its current sweep.
+ *
+ * The sweep is quantized to a quarter pixel of arc length at the outer edge.
+ * If the quantized sweep is unchanged nothing is generated or uploaded. If
+ * the arc grew, only the new body edges, the tail and the end cap are
+ * generated and written with glBufferSubData. The mesh is rebuilt from
+ * scratch on first use, on resize (new segment budget), on a vertex format
+ * change, or when the arc shrinks (e.g. wrapping around at the top of the
+ * minute).
+ *
+ * @param cache       The ring's cache entry.
+ * @param innerRadius Inner radius of the arc ring.
+ * @param outerRadius Outer radius of the arc ring.
+ * @param value       Arc sweep as a fraction of a full circle (0.0 to 1.0).
+ */
+void ArcRenderer::updateArcMesh(ArcMeshCache& cache, double innerRadius, double outerRadius,
+                                double value) {
+    const SegmentBudget& budget = getSegmentBudget(innerRadius, outerRadius);
+
+    double quantum = SWEEP_QUANTUM_PIXELS / (outerRadius * m_pixelScale * math::TAU);
+    long long quantizedSweep = std::llround(std::min(value, 1.0) / quantum);
+
+    bool layoutChanged = cache.vao == 0 ||
+                         cache.innerRadius != innerRadius ||
+                         cache.outerRadius != outerRadius ||
+                         cache.circleSegments != budget.circleSegments ||
+                         cache.endcapSegments != budget.endcapSegments ||
+                         cache.compact != m_compactVertices;
+
+    if (!layoutChanged && quantizedSweep == cache.quantizedSweep) return;
+
+    ArcLayout layout = computeArcLayout(innerRadius, outerRadius, quantizedSweep * quantum,
+                                        budget.circleSegments);
+
+    const GLsizei stride = m_compactVertices ? 2 * sizeof(uint16_t) : 2 * sizeof(float);
+
+    if (!layoutChanged && quantizedSweep > cache.quantizedSweep &&
+        layout.fullSegments >= cache.fullSegments) {
+        // Grow in place: new body edges, then the moving tail and end cap
+        m_polarVertices.clear();
+        appendBody(m_polarVertices, innerRadius, outerRadius, layout, cache.fullSegments + 1);
+        appendTail(m_polarVertices, innerRadius, outerRadius, layout, budget.endcapSegments);
+        size_t bytes = 0;
+        const void* data = encodeVertices(m_polarVertices, outerRadius, bytes);
+
+        GLsizei first = cache.bodyStart + (cache.fullSegments + 1) * 2;
+        GLState::instance().bindBuffer(GL_ARRAY_BUFFER, cache.vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, first * stride, bytes, data);
+
+        cache.vertexCount = first + static_cast<GLsizei>(m_polarVertices.size());
+    } else {
+        m_polarVertices.clear();
+        appendStartCap(m_polarVertices, innerRadius, outerRadius, layout, budget.endcapSegments);
+        cache.bodyStart = static_cast<GLsizei>(m_polarVertices.size());
+        appendBody(m_polarVertices, innerRadius, outerRadius, layout, 0);
+        appendTail(m_polarVertices, innerRadius, outerRadius, layout, budget.endcapSegments);
+        size_t bytes = 0;
+        const void* data = encodeVertices(m_polarVertices, outerRadius, bytes);
+
+        if (!cache.vao) {
+            glGenVertexArrays(1, &cache.vao);
+            glGenBuffers(1, &cache.vbo);
+        }
 
-    // Generate main arc body
-    int numSegments = static_cast<int>(SEGMENTS * endAngle) + 1;
-    numSegments = std::max(numSegments, 3);
+        // Size for a full circle so later growth never needs to reallocate:
+        // both endcaps, every body edge and the tail edge
+        GLsizei capacity = (budget.endcapSegments * 2 + budget.circleSegments + 2) * 2;
 
-    double lastAngle = mainStart;
-    for (int i = 0; i < numSegments; ++i) {
-        double t1 = static_cast<float>(i + 1) / numSegments;
+        GLState::instance().bindVertexArray(cache.vao);
+        GLState::instance().bindBuffer(GL_ARRAY_BUFFER, cache.vbo);
+        if (capacity != cache.capacity || cache.compact != m_compactVertices) {
+            glBufferData(GL_ARRAY_BUFFER, capacity * stride, nullptr, GL_DYNAMIC_DRAW);
+            cache.capacity = capacity;
+        }
+        setVertexFormat(0);
+        glEnableVertexAttribArray(0);
 
-        double a0 = lastAngle;
-        double a1 = mainStart - t1 * mainSweep;
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
 
-        double c0 = std::cos(a0), s0 = std::sin(a0);
-        double c1 = std::cos(a1), s1 = std::sin(a1);
+        cache.vertexCount = static_cast<GLsizei>(m_polarVertices.size());
+        cache.innerRadius = innerRadius;
+        cache.outerRadius = outerRadius;
+        cache.circleSegments = budget.circleSegments;
+        cache.endcapSegments = budget.endcapSegments;
+        cache.compact = m_compactVertices;
+    }
 
-        pushQuad(vertices, innerRadius, outerRadius, c0, s0,
-                          innerRadius, outerRadius, c1, s1);
+    cache.quantizedSweep = quantizedSweep;
+    cache.fullSegments = layout.fullSegments;
+}
 
-        lastAngle = a1;
+/**
+ * @brief Render arcs from their persistent per-ring meshes.
+ *
+ * Arcs are identified by their position in the list, so callers should pass
+ * rings in a stable order each frame.
+ *
+ * @param arcs       Arcs to render.
+ */
+void ArcRenderer::renderArcsCached(const std::vector<ArcInstance>& arcs) {
+    if (m_meshCache.size() < arcs.size()) {
+        m_meshCache.resize(arcs.size());
     }
 
-    // Generate start endcap (rounded corners at arc start)
-    generateEndcap(vertices, innerRadius, outerRadius, cr,
-                   arcStart, endcapAngularSize, arcStart);
+    m_shader.use();
+
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        const ArcInstance& arc = arcs[i];
+        if (arc.value <= 0.001f) continue;
 
-    // Generate end endcap (rounded corners at arc end)
-    double endEndcapStart = mainStart - mainSweep;
-    generateEndcap(vertices, innerRadius, outerRadius, cr,
-                   endEndcapStart, endcapAngularSize, arcEnd);
+        ArcMeshCache& cache = m_meshCache[i];
+        updateArcMesh(cache, arc.innerRadius, arc.outerRadius, arc.value);
+        if (cache.vertexCount == 0) continue;
+
+        m_shader.setVec3(m_meshUniforms.colorBase, arc.color.x, arc.color.y, arc.color.z);
+        setVertexFormatUniforms(arc.outerRadius);
+
+        GLState::instance().bindVertexArray(cache.vao);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, cache.vertexCount);
+    }
 }
 
 /**
  * @brief Render all arcs for a polar clock.
  *
  * Iterates through all rings in the clock and renders each one as an arc
- * with the appropriate color. Geometry is regenerated each frame to support
- * smooth animation of the arc sweep values.
+ * with the appropriate color, using the currently selected arc engine.
  *
  * @param clock      The PolarClock containing ring data to render.
- * @param projection The projection matrix for coordinate transformation.
  */
-void ArcRenderer::render(const PolarClock& clock, const math::Mat4& projection) {
-    m_shader.use();
-    m_shader.setMat4("u_projection", projection.data());
+void ArcRenderer::render(const PolarClock& clock) {
+    for (const auto& ring : clock.getRings()) {
+        renderArc(ring.innerRadius, ring.outerRadius, ring.currentValue, ring.colors.base);
+    }
+}
 
-    glBindVertexArray(m_vao);
+/**
+ * @brief Render a set of arcs.
+ *
+ * In instanced mode all arcs are drawn with a single draw call. In mesh
+ * mode each arc keeps a persistent, incrementally updated mesh. The SDF
+ * mode draws each arc individually.
+ *
+ * @param arcs       Arcs to render, in draw order.
+ */
+void ArcRenderer::renderArcs(const std::vector<ArcInstance>& arcs) {
+    if (m_mode == ArcRenderMode::Instanced) {
+        renderArcsInstanced(arcs);
+        return;
+    }
 
-    for (const auto& ring : clock.getRings()) {
-        if (ring.currentValue <= 0.001f) continue;
+    if (m_mode == ArcRenderMode::Mesh) {
+        renderArcsCached(arcs);
+        return;
+    }
 
-        std::vector<float> vertices;
-        generateArcGeometry(ring.innerRadius, ring.outerRadius, ring.currentValue, vertices);
+    for (const auto& arc : arcs) {
+        renderArc(arc.innerRadius, arc.outerRadius, arc.value, arc.color);
+    }
+}
 
-        if (vertices.empty()) continue;
+/**
+ * @brief Size of the largest mesh renderArc() streams: a full circle at the
+ * finest tessellation, with float2 positions.
+ *
+ * Each endcap adds at most MAX_ENDCAP_SEGMENTS edges and the body at most
+ * MAX_CIRCLE_SEGMENTS + 2 (its full segments plus the tail edge); every edge
+ * is an inner and an outer vertex.
+ */
+GLsizeiptr ArcRenderer::getMaxStreamBytes() {
+    const int edges = MAX_CIRCLE_SEGMENTS + 2 + 2 * MAX_ENDCAP_SEGMENTS;
+    return static_cast<GLsizeiptr>(edges * 2 * 2 * sizeof(float));
+}
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+void ArcRenderer::submit(RenderGraph& graph, RenderPass pass, const ArcInstance& arc) {
+    const Shader& shader = m_mode == ArcRenderMode::Sdf ? m_sdfShader
+                         : m_mode == ArcRenderMode::Instanced ? m_instancedShader
+                         : m_shader;
+    DrawState state;
+    state.program = shader.getProgram();
 
-        m_shader.setVec3("u_colorBase", ring.colors.base.x, ring.colors.base.y, ring.colors.base.z);
+    graph.submit(pass, state, *this, static_cast<uint32_t>(m_submitted.size()));
+    m_submitted.push_back(arc);
+}
 
-        // Draw as triangles (2 floats per vertex)
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size() / 2));
+void ArcRenderer::drawBatch(const uint32_t* items, size_t count) {
+    m_batchArcs.clear();
+    for (size_t i = 0; i < count; ++i) {
+        m_batchArcs.push_back(m_submitted[items[i]]);
     }
-
-    glBindVertexArray(0);
+    renderArcs(m_batchArcs);
 }
 
 /**
@@ -258,28 +521,116 @@ void ArcRenderer::render(const PolarClock& clock, const math::Mat4& projection)
  * @param outerRadius Outer radius of the arc ring.
  * @param value       Arc sweep as a fraction of a full circle (0.0 to 1.0).
  * @param color       RGB color for the arc.
- * @param projection  The projection matrix for coordinate transformation.
  */
 void ArcRenderer::renderArc(double innerRadius, double outerRadius, double value,
-                             const math::Vec3& color, const math::Mat4& projection) {
+                             const math::Vec3& color) {
     if (value <= 0.001f) return;
 
+    if (m_mode == ArcRenderMode::Sdf) {
+        renderArcSdf(innerRadius, outerRadius, value, color);
+        return;
+    }
+
+    if (m_mode == ArcRenderMode::Instanced) {
+        ArcInstance arc = { static_cast<float>(innerRadius), static_cast<float>(outerRadius),
+                            static_cast<float>(value), color };
+        renderArcsInstanced(std::vector<ArcInstance>{ arc });
+        return;
+    }
+
+    generateArcGeometry(innerRadius, outerRadius, value, m_polarVertices);
+    if (m_polarVertices.empty()) return;
+
+    const GLsizei stride = m_compactVertices ? 2 * sizeof(uint16_t) : 2 * sizeof(float);
+    size_t bytes = 0;
+    const void* data = encodeVertices(m_polarVertices, outerRadius, bytes);
+    GLintptr offset = m_stream->upload(data, bytes, stride);
+    if (offset == StreamBuffer::UPLOAD_FAILED) return;
+
     m_shader.use();
-    m_shader.setMat4("u_projection", projection.data());
-    m_shader.setVec3("u_colorBase", color.x, color.y, color.z);
+    m_shader.setVec3(m_meshUniforms.colorBase, color.x, color.y, color.z);
+    setVertexFormatUniforms(outerRadius);
+
+    GLState::instance().bindVertexArray(m_vao);
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_stream->getBuffer());
+    setVertexFormat(0);
+    glDrawArrays(GL_TRIANGLE_STRIP, static_cast<GLint>(offset / stride),
+                 static_cast<GLsizei>(m_polarVertices.size()));
+}
+
+/**
+ * @brief Render a single arc as a signed distance field.
+ *
+ * Draws one quad covering the ring's bounding square. The fragment shader
+ * evaluates the distance to the rounded annular sector and antialiases from
+ * it, so CPU cost per ring is a handful of uniform uploads regardless of
+ * sweep or screen size.
+ *
+ * The corner radius matches the tessellated path (10% of ring thickness).
+ *
+ * @param innerRadius Inner radius of the arc ring.
+ * @param outerRadius Outer radius of the arc ring.
+ * @param value       Arc sweep as a fraction of a full circle (0.0 to 1.0).
+ * @param color       RGB color for the arc.
+ */
+void ArcRenderer::renderArcSdf(double innerRadius, double outerRadius, double value,
+                                const math::Vec3& color) {
+    double ringThickness = outerRadius - innerRadius;
+
+    m_sdfShader.use();
+    m_sdfShader.setVec3(m_sdfUniforms.colorBase, color.x, color.y, color.z);
+    m_sdfShader.setFloat(m_sdfUniforms.innerRadius, static_cast<float>(innerRadius));
+    m_sdfShader.setFloat(m_sdfUniforms.outerRadius, static_cast<float>(outerRadius));
+    m_sdfShader.setFloat(m_sdfUniforms.sweep, static_cast<float>(std::min(value, 1.0) * math::TAU));
+    m_sdfShader.setFloat(m_sdfUniforms.cornerRadius, static_cast<float>(ringThickness * 0.1));
 
-    glBindVertexArray(m_vao);
+    // Pad the quad slightly so the antialiased outer edge is not clipped
+    m_sdfShader.setFloat(m_sdfUniforms.extent, static_cast<float>(outerRadius + ringThickness * 0.1));
 
-    std::vector<float> vertices;
-    generateArcGeometry(innerRadius, outerRadius, value, vertices);
+    GLState::instance().bindVertexArray(m_quadVao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
 
-    if (!vertices.empty()) {
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size() / 2));
+/**
+ * @brief Render arcs as instances of the static unit mesh.
+ *
+ * Packs one (inner, outer, sweep, color) record per visible arc, streams
+ * them in a single upload and issues one instanced draw, so CPU cost
+ * stays flat as the ring count grows.
+ *
+ * @param arcs       Arcs to render.
+ */
+void ArcRenderer::renderArcsInstanced(const std::vector<ArcInstance>& arcs) {
+    m_instanceData.clear();
+    for (const auto& arc : arcs) {
+        if (arc.value <= 0.001f) continue;
+
+        m_instanceData.push_back(arc.innerRadius);
+        m_instanceData.push_back(arc.outerRadius);
+        m_instanceData.push_back(std::min(arc.value, 1.0f));
+        m_instanceData.push_back(arc.color.x);
+        m_instanceData.push_back(arc.color.y);
+        m_instanceData.push_back(arc.color.z);
     }
 
-    glBindVertexArray(0);
+    if (m_instanceData.empty()) return;
+
+    const GLsizei stride = 6 * sizeof(float);
+    GLintptr offset = m_stream->upload(m_instanceData.data(),
+                                       m_instanceData.size() * sizeof(float), stride);
+    if (offset == StreamBuffer::UPLOAD_FAILED) return;
+
+    m_instancedShader.use();
+
+    GLState::instance().bindVertexArray(m_instancedVao);
+
+    // Instance layout: inner, outer, sweep, r, g, b
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_stream->getBuffer());
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + 3 * sizeof(float)));
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, m_unitMeshVertexCount,
+                          static_cast<GLsizei>(m_instanceData.size() / 6));
 }
 
 } // namespace polarclock
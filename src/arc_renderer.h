@@ -1,33 +1,165 @@
 #pragma once
 
 #include "shader.h"
+#include "stream_buffer.h"
+#include "render_graph.h"
+#include "arc_kernel.h"
 #include "polar_clock.h"
 #include "pcmath.h"
 #include <vector>
+#include <cstdint>
 
 namespace polarclock {
 
-class ArcRenderer {
+// Arc drawing strategy, selectable at runtime for A/B comparison
+enum class ArcRenderMode {
+    Mesh,       // CPU-tessellated triangle mesh, updated incrementally per ring
+    Sdf,        // One bounding quad per ring, shaped by a signed distance field
+    Instanced   // Static unit mesh, all rings in a single instanced draw call
+};
+
+// Per-ring parameters for batched arc rendering
+struct ArcInstance {
+    float innerRadius;
+    float outerRadius;
+    float value;        // Arc sweep as a fraction of a full circle (0.0 to 1.0)
+    math::Vec3 color;
+};
+
+class ArcRenderer : public DrawBatcher {
 public:
     ArcRenderer();
     ~ArcRenderer();
 
-    bool init();
-    void render(const PolarClock& clock, const math::Mat4& projection);
+    // Create buffers and submit the arc programs; call waitForPrograms()
+    // before drawing
+    bool init(StreamBuffer& stream);
+    void pollPrograms();
+    bool waitForPrograms();
+    void render(const PolarClock& clock);
+
+    // Render a set of arcs, batched into one draw call when the mode allows it
+    void renderArcs(const std::vector<ArcInstance>& arcs);
 
     // Render a single arc with explicit parameters
     void renderArc(double innerRadius, double outerRadius, double value,
-                   const math::Vec3& color, const math::Mat4& projection);
+                   const math::Vec3& color);
+
+    // Most stream buffer bytes renderArc() can use for one arc
+    static GLsizeiptr getMaxStreamBytes();
+
+    // Queue an arc as a packet in `graph`. Arcs merged into one batch are
+    // drawn like renderArcs(), so submit rings in a stable order each frame.
+    void submit(RenderGraph& graph, RenderPass pass, const ArcInstance& arc);
+    void drawBatch(const uint32_t* items, size_t count) override;
+    void clearSubmitted() override { m_submitted.clear(); }
+
+    void setMode(ArcRenderMode mode) { m_mode = mode; }
+    ArcRenderMode getMode() const { return m_mode; }
+
+    // Encode mesh vertices as 16-bit polar pairs instead of float2 positions
+    void setCompactVertices(bool compact) { m_compactVertices = compact; }
+    bool getCompactVertices() const { return m_compactVertices; }
+
+    // Pixels per world unit; segment budgets are recomputed when this changes
+    void setPixelScale(float pixelsPerUnit);
 
 private:
+    // Tessellation density for one ring at the current pixel scale
+    struct SegmentBudget {
+        double innerRadius;
+        double outerRadius;
+        int circleSegments;   // Body segments per full circle
+        int endcapSegments;   // Segments per rounded endcap
+    };
+
+    // Persistent per-ring mesh, updated incrementally as the arc grows
+    struct ArcMeshCache {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLsizei capacity = 0;          // Vertices the VBO can hold
+        GLsizei vertexCount = 0;
+        GLsizei bodyStart = 0;         // First body vertex (after the start cap)
+        int fullSegments = 0;          // Full body segments currently in the mesh
+        long long quantizedSweep = -1;
+        double innerRadius = 0.0;
+        double outerRadius = 0.0;
+        int circleSegments = 0;
+        int endcapSegments = 0;
+        bool compact = false;          // Vertex format the VBO was filled with
+    };
+
+    const SegmentBudget& getSegmentBudget(double innerRadius, double outerRadius);
+    void updateArcMesh(ArcMeshCache& cache, double innerRadius, double outerRadius, double value);
+    void renderArcsCached(const std::vector<ArcInstance>& arcs);
     void generateArcGeometry(double innerRadius, double outerRadius, double endAngle,
-                             std::vector<float>& vertices);
+                             std::vector<PolarVertex>& vertices);
+    const void* encodeVertices(const std::vector<PolarVertex>& vertices, double outerRadius,
+                               size_t& bytes);
+    void setVertexFormat(GLintptr offset) const;
+    void setVertexFormatUniforms(double outerRadius);
+    void renderArcSdf(double innerRadius, double outerRadius, double value,
+                      const math::Vec3& color);
+    void renderArcsInstanced(const std::vector<ArcInstance>& arcs);
+    bool initInstanced();
+
+    // Uniform handles, looked up once the programs have linked
+    struct MeshUniforms {
+        int colorBase = -1;
+        int polar = -1;
+        int radiusScale = -1;
+    };
+    struct SdfUniforms {
+        int colorBase = -1;
+        int innerRadius = -1;
+        int outerRadius = -1;
+        int sweep = -1;
+        int cornerRadius = -1;
+        int extent = -1;
+    };
+
+    StreamBuffer* m_stream;  // Shared per-frame vertex storage, owned by Renderer
+
+    std::vector<ArcInstance> m_submitted;   // Arcs queued through submit()
+    std::vector<ArcInstance> m_batchArcs;   // The arcs of the batch being drawn
 
     Shader m_shader;
+    MeshUniforms m_meshUniforms;
     GLuint m_vao;
-    GLuint m_vbo;
+    std::vector<PolarVertex> m_polarVertices;
+    std::vector<float> m_encoded;            // float2 positions
+    std::vector<uint16_t> m_compactEncoded;  // 16-bit polar pairs
+
+    Shader m_sdfShader;
+    SdfUniforms m_sdfUniforms;
+    GLuint m_quadVao;
+    GLuint m_quadVbo;
+
+    Shader m_instancedShader;
+    GLuint m_instancedVao;
+    GLuint m_unitMeshVbo;
+    GLsizei m_unitMeshVertexCount;
+    std::vector<float> m_instanceData;
+
+    ArcRenderMode m_mode;
+    bool m_compactVertices;
+
+    float m_pixelScale;
+    std::vector<SegmentBudget> m_segmentBudgets;  // One per distinct ring, cleared on resize
+    std::vector<ArcMeshCache> m_meshCache;        // Indexed by position in renderArcs()
+
+    static constexpr int SEGMENTS = 128;        // Segments per full circle (instanced mesh)
+    static constexpr int ENDCAP_SEGMENTS = 12;  // Segments per rounded endcap (instanced mesh)
+
+    // Adaptive tessellation limits for the mesh path
+    static constexpr double MAX_CHORD_ERROR = 0.25;  // Pixels
+    static constexpr int MIN_CIRCLE_SEGMENTS = 16;
+    static constexpr int MAX_CIRCLE_SEGMENTS = 1024;
+    static constexpr int MIN_ENDCAP_SEGMENTS = 2;
+    static constexpr int MAX_ENDCAP_SEGMENTS = 12;
 
-    static constexpr int SEGMENTS = 128;  // Segments per full circle
+    // Sweep changes smaller than this (arc length at the outer edge) are not redrawn
+    static constexpr double SWEEP_QUANTUM_PIXELS = 0.25;
 };
 
 } // namespace polarclock
@@ -0,0 +1,338 @@
+#include "font_atlas.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+#ifndef POLARCLOCK_NO_FONT_RASTER
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
+#endif
+
+namespace polarclock {
+
+static constexpr char FONT_ATLAS_MAGIC[4] = { 'P', 'C', 'F', 'A' };
+static constexpr uint32_t FONT_ATLAS_VERSION = 1;
+static constexpr size_t GLYPH_FLOATS = sizeof(GlyphInfo) / sizeof(float);
+
+static_assert(sizeof(GlyphInfo) == GLYPH_FLOATS * sizeof(float), "GlyphInfo must be plain floats");
+
+template <typename T>
+static void put(std::vector<unsigned char>& out, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static bool get(const std::vector<unsigned char>& data, size_t& cursor, T& value) {
+    if (data.size() - cursor < sizeof(T)) return false;
+    std::memcpy(&value, data.data() + cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+void writeFontAtlas(const FontAtlas& atlas, std::vector<unsigned char>& out) {
+    out.clear();
+    out.reserve(4 + 6 * sizeof(uint32_t)
+                + atlas.glyphs.size() * (sizeof(uint32_t) + sizeof(GlyphInfo))
+                + atlas.pixels.size());
+    out.insert(out.end(), FONT_ATLAS_MAGIC, FONT_ATLAS_MAGIC + 4);
+    put(out, FONT_ATLAS_VERSION);
+    put(out, static_cast<uint32_t>(atlas.mode));
+    put(out, atlas.fontSize);
+    put(out, static_cast<uint32_t>(atlas.width));
+    put(out, static_cast<uint32_t>(atlas.height));
+    put(out, static_cast<uint32_t>(atlas.glyphs.size()));
+    for (const FontAtlas::Glyph& glyph : atlas.glyphs) {
+        put(out, glyph.codepoint);
+        put(out, glyph.info);
+    }
+    out.insert(out.end(), atlas.pixels.begin(), atlas.pixels.end());
+}
+
+bool readFontAtlas(const std::vector<unsigned char>& data, FontAtlas& atlas) {
+    if (data.size() < 4 || std::memcmp(data.data(), FONT_ATLAS_MAGIC, 4) != 0) {
+        return false;
+    }
+
+    size_t cursor = 4;
+    uint32_t version = 0, mode = 0, width = 0, height = 0, glyphCount = 0;
+    if (!get(data, cursor, version) || version != FONT_ATLAS_VERSION) return false;
+    if (!get(data, cursor, mode) || mode > static_cast<uint32_t>(FontAtlasMode::Sdf)) return false;
+    if (!get(data, cursor, atlas.fontSize)) return false;
+    if (!get(data, cursor, width) || !get(data, cursor, height)) return false;
+    if (!get(data, cursor, glyphCount)) return false;
+
+    size_t glyphBytes = static_cast<size_t>(glyphCount) * (sizeof(uint32_t) + sizeof(GlyphInfo));
+    size_t pixelBytes = static_cast<size_t>(width) * height;
+    if (data.size() - cursor != glyphBytes + pixelBytes) return false;
+
+    atlas.mode = static_cast<FontAtlasMode>(mode);
+    atlas.width = static_cast<int>(width);
+    atlas.height = static_cast<int>(height);
+    atlas.glyphs.resize(glyphCount);
+    for (FontAtlas::Glyph& glyph : atlas.glyphs) {
+        get(data, cursor, glyph.codepoint);
+        get(data, cursor, glyph.info);
+    }
+    atlas.pixels.assign(data.begin() + cursor, data.end());
+    return true;
+}
+
+std::string bakedFontAtlasPath(const std::string& fontPath, float fontSize, FontAtlasMode mode) {
+    size_t slash = fontPath.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "" : fontPath.substr(0, slash + 1);
+    std::string name = slash == std::string::npos ? fontPath : fontPath.substr(slash + 1);
+    name = name.substr(0, name.find_last_of('.'));
+
+    return dir + "baked/" + name + "-" + std::to_string(static_cast<int>(fontSize)) +
+           (mode == FontAtlasMode::Sdf ? "-sdf" : "") + ".pcfa";
+}
+
+static constexpr int SDF_ATLAS_SIZE = 256;
+static constexpr int BITMAP_ATLAS_SIZE = 512;
+
+int fontAtlasPageSize(FontAtlasMode mode) {
+    return mode == FontAtlasMode::Sdf ? SDF_ATLAS_SIZE : BITMAP_ATLAS_SIZE;
+}
+
+SkylinePacker::SkylinePacker()
+    : m_width(0)
+    , m_height(0)
+{
+}
+
+void SkylinePacker::reset(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_skyline.assign(1, Segment{ 0, 0, width });
+}
+
+/**
+ * @brief Lowest y at which a rectangle starting at segment `index` clears the skyline.
+ *
+ * @return The y coordinate, or -1 if the rectangle would run off the right edge.
+ */
+int SkylinePacker::fitY(size_t index, int width) const {
+    int x = m_skyline[index].x;
+    if (x + width > m_width) return -1;
+
+    int y = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0; ++i) {
+        y = std::max(y, m_skyline[i].y);
+        remaining -= m_skyline[i].width;
+    }
+    return y;
+}
+
+/**
+ * @brief Place a rectangle at the lowest position, preferring the leftmost on ties.
+ *
+ * The skyline segments it covers are replaced by one segment at its top edge
+ * and neighbours of equal height are merged.
+ *
+ * @return true with the rectangle's top-left corner in x, y; false if it does not fit.
+ */
+bool SkylinePacker::pack(int width, int height, int& x, int& y) {
+    size_t best = m_skyline.size();
+    int bestY = m_height;
+    for (size_t i = 0; i < m_skyline.size(); ++i) {
+        int fit = fitY(i, width);
+        if (fit >= 0 && fit + height <= m_height && fit < bestY) {
+            best = i;
+            bestY = fit;
+        }
+    }
+    if (best == m_skyline.size()) return false;
+
+    x = m_skyline[best].x;
+    y = bestY;
+
+    // Cut the covered width out of the following segments
+    int right = x + width;
+    size_t next = best;
+    while (next < m_skyline.size() && m_skyline[next].x < right) {
+        Segment& segment = m_skyline[next];
+        int segmentRight = segment.x + segment.width;
+        if (segmentRight <= right) {
+            ++next;
+            continue;
+        }
+        segment.width = segmentRight - right;
+        segment.x = right;
+        break;
+    }
+    m_skyline.erase(m_skyline.begin() + best, m_skyline.begin() + next);
+    m_skyline.insert(m_skyline.begin() + best, Segment{ x, y + height, width });
+
+    for (size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+    return true;
+}
+
+#ifndef POLARCLOCK_NO_FONT_RASTER
+
+// SDF glyphs are baked at SDF_BAKE_SIZE pixels with SDF_PADDING pixels of
+// distance falloff around them
+static constexpr float SDF_BAKE_SIZE = 32.0f;
+static constexpr int SDF_PADDING = 3;  // 4 overflows 256x256 for RobotoMono-Bold
+
+GlyphRasterizer::GlyphRasterizer()
+    : m_mode(FontAtlasMode::Bitmap)
+    , m_scale(1.0f)
+    , m_metricScale(1.0f)
+    , m_padding(0)
+{
+}
+
+GlyphRasterizer::~GlyphRasterizer() = default;
+
+/**
+ * @brief Prepare to rasterize a font at a layout size.
+ *
+ * In bitmap mode glyphs are rasterized as coverage at the layout font size.
+ * In SDF mode they are rasterized with stbtt_GetGlyphSDF at SDF_BAKE_SIZE,
+ * and metrics are scaled back up to the layout font size so layout is
+ * unaffected.
+ *
+ * @return true if the font could be read, false otherwise.
+ */
+bool GlyphRasterizer::init(const std::vector<unsigned char>& fontData, float fontSize,
+                           FontAtlasMode mode) {
+    m_font.reset(new stbtt_fontinfo());
+    m_glyphIndices.clear();
+    if (!stbtt_InitFont(m_font.get(), fontData.data(), 0)) {
+        std::cerr << "Failed to initialize font" << std::endl;
+        m_font.reset();
+        return false;
+    }
+
+    bool sdf = mode == FontAtlasMode::Sdf;
+    float bakeSize = sdf ? SDF_BAKE_SIZE : fontSize;
+    m_mode = mode;
+    m_scale = stbtt_ScaleForPixelHeight(m_font.get(), bakeSize);
+    m_metricScale = fontSize / bakeSize;
+    m_padding = sdf ? SDF_PADDING : 0;
+    return true;
+}
+
+/**
+ * @brief Font glyph index for a codepoint, memoized.
+ *
+ * stbtt_FindGlyphIndex walks the font's cmap on every call, and the
+ * stbtt_*Codepoint* functions call it again for each of bitmap and metrics.
+ * Caching the result means an evicted glyph is re-rasterized without any
+ * cmap lookup.
+ */
+int GlyphRasterizer::glyphIndex(uint32_t codepoint) {
+    auto it = m_glyphIndices.find(codepoint);
+    if (it != m_glyphIndices.end()) {
+        return it->second;
+    }
+
+    int glyph = stbtt_FindGlyphIndex(m_font.get(), static_cast<int>(codepoint));
+    m_glyphIndices.emplace(codepoint, glyph);
+    return glyph;
+}
+
+/**
+ * @brief Rasterize one glyph.
+ *
+ * SDF quads grow by the padding on every side; the ink size used for
+ * layout does not.
+ */
+bool GlyphRasterizer::rasterize(uint32_t codepoint, GlyphInfo& info, std::vector<unsigned char>& pixels,
+                                int& width, int& height) {
+    width = height = 0;
+    int glyph = glyphIndex(codepoint);
+    if (glyph == 0) {
+        return false;
+    }
+
+    int xoff = 0, yoff = 0;
+    unsigned char* bitmap = m_mode == FontAtlasMode::Sdf
+        // 128 is the outline; distances fall to 0 over `padding` pixels
+        ? stbtt_GetGlyphSDF(m_font.get(), m_scale, glyph, m_padding, 128, 128.0f / m_padding,
+                            &width, &height, &xoff, &yoff)
+        : stbtt_GetGlyphBitmap(m_font.get(), 0, m_scale, glyph, &width, &height, &xoff, &yoff);
+
+    pixels.assign(bitmap, bitmap + (bitmap ? width * height : 0));
+    stbtt_FreeBitmap(bitmap, nullptr);
+
+    info = GlyphInfo();
+    info.xoff = xoff * m_metricScale;
+    info.yoff = yoff * m_metricScale;
+    info.width = width * m_metricScale;
+    info.height = height * m_metricScale;
+    info.inkWidth = std::max(width - 2 * m_padding, 0) * m_metricScale;
+    info.inkHeight = std::max(height - 2 * m_padding, 0) * m_metricScale;
+
+    int advanceWidth, leftSideBearing;
+    stbtt_GetGlyphHMetrics(m_font.get(), glyph, &advanceWidth, &leftSideBearing);
+    info.xadvance = advanceWidth * m_scale * m_metricScale;
+    return true;
+}
+
+/**
+ * @brief Rasterize printable ASCII into a single skyline-packed atlas page.
+ *
+ * @param fontData TrueType file contents.
+ * @param fontSize Layout font size in pixels.
+ * @param mode     Bitmap or SDF.
+ * @param atlas    Output atlas.
+ * @return true if the font could be read and every glyph fit, false otherwise.
+ */
+bool bakeFontAtlas(const std::vector<unsigned char>& fontData, float fontSize,
+                   FontAtlasMode mode, FontAtlas& atlas) {
+    GlyphRasterizer rasterizer;
+    if (!rasterizer.init(fontData, fontSize, mode)) {
+        return false;
+    }
+
+    atlas.mode = mode;
+    atlas.fontSize = fontSize;
+    atlas.width = atlas.height = fontAtlasPageSize(mode);
+    atlas.glyphs.clear();
+    atlas.pixels.assign(atlas.width * atlas.height, 0);
+
+    SkylinePacker packer;
+    packer.reset(atlas.width - GLYPH_SPACING, atlas.height - GLYPH_SPACING);
+
+    std::vector<unsigned char> bitmap;
+    for (uint32_t c = 32; c < 127; ++c) {
+        GlyphInfo glyph;
+        int width, height, x, y;
+        if (!rasterizer.rasterize(c, glyph, bitmap, width, height)) continue;
+
+        if (!packer.pack(width + GLYPH_SPACING, height + GLYPH_SPACING, x, y)) {
+            std::cerr << "Font atlas too small at glyph " << c << std::endl;
+            return false;
+        }
+        x += GLYPH_SPACING;
+        y += GLYPH_SPACING;
+
+        // Copy glyph to atlas
+        for (int row = 0; row < height; ++row) {
+            std::memcpy(&atlas.pixels[(y + row) * atlas.width + x],
+                       &bitmap[row * width], width);
+        }
+
+        glyph.x0 = static_cast<float>(x) / atlas.width;
+        glyph.y0 = static_cast<float>(y) / atlas.height;
+        glyph.x1 = static_cast<float>(x + width) / atlas.width;
+        glyph.y1 = static_cast<float>(y + height) / atlas.height;
+        atlas.glyphs.push_back({ c, glyph });
+    }
+
+    return true;
+}
+
+#endif
+
+} // namespace polarclock
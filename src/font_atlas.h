@@ -0,0 +1,143 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#ifndef POLARCLOCK_NO_FONT_RASTER
+struct stbtt_fontinfo;
+#endif
+
+namespace polarclock {
+
+// How glyphs are stored in the font atlas
+enum class FontAtlasMode {
+    Bitmap,  // Coverage rasterized at the layout font size
+    Sdf      // Signed distance field at a small size, sharp at any scale
+};
+
+struct GlyphInfo {
+    float x0, y0, x1, y1;         // Texture coordinates
+    float xoff, yoff;             // Offset from cursor
+    float xadvance;               // Advance to next character
+    float width, height;          // Quad dimensions (including any SDF padding)
+    float inkWidth, inkHeight;    // Glyph dimensions without padding
+};
+
+/**
+ * @brief A baked font: single-channel atlas pixels plus glyph metrics.
+ *
+ * Metrics are in pixels at fontSize (the layout size) whatever size the
+ * atlas was rasterized at.
+ */
+struct FontAtlas {
+    struct Glyph {
+        uint32_t codepoint;
+        GlyphInfo info;
+    };
+
+    FontAtlasMode mode = FontAtlasMode::Bitmap;
+    float fontSize = 0.0f;
+    int width = 0;
+    int height = 0;
+    std::vector<Glyph> glyphs;
+    std::vector<unsigned char> pixels;  // width * height, R8
+};
+
+// Side length of an atlas page (and of a baked atlas) for a mode
+int fontAtlasPageSize(FontAtlasMode mode);
+
+// Texels left empty around every packed glyph so linear filtering never
+// picks up a neighbour
+constexpr int GLYPH_SPACING = 2;
+
+/**
+ * @brief Skyline bottom-left rectangle packer.
+ *
+ * Tracks the top edge of the packed area as a list of horizontal segments
+ * and places each rectangle where it ends up lowest, which wastes much less
+ * space than shelf packing for glyphs of mixed heights.
+ */
+class SkylinePacker {
+public:
+    SkylinePacker();
+
+    void reset(int width, int height);
+
+    // Find space for a rectangle; false if it does not fit
+    bool pack(int width, int height, int& x, int& y);
+
+private:
+    struct Segment {
+        int x, y, width;
+    };
+
+    int fitY(size_t index, int width) const;
+
+    std::vector<Segment> m_skyline;
+    int m_width;
+    int m_height;
+};
+
+/**
+ * @brief Serialize an atlas to the baked font format (.pcfa).
+ *
+ * Layout (little-endian): "PCFA", u32 version, u32 mode, f32 font size,
+ * u32 width, u32 height, u32 glyph count, then per glyph u32 codepoint and
+ * the eleven GlyphInfo floats, then the atlas pixels.
+ */
+void writeFontAtlas(const FontAtlas& atlas, std::vector<unsigned char>& out);
+
+/**
+ * @brief Parse a baked font; fails on a bad magic, version or size.
+ */
+bool readFontAtlas(const std::vector<unsigned char>& data, FontAtlas& atlas);
+
+/**
+ * @brief Path of the baked atlas for a font, e.g. assets/baked/RobotoMono-Bold-72-sdf.pcfa.
+ */
+std::string bakedFontAtlasPath(const std::string& fontPath, float fontSize, FontAtlasMode mode);
+
+#ifndef POLARCLOCK_NO_FONT_RASTER
+/**
+ * @brief Rasterizes single glyphs from TrueType data with stb_truetype.
+ *
+ * The font data is referenced, not copied, and must outlive the rasterizer.
+ */
+class GlyphRasterizer {
+public:
+    GlyphRasterizer();
+    ~GlyphRasterizer();
+
+    bool init(const std::vector<unsigned char>& fontData, float fontSize, FontAtlasMode mode);
+
+    // Rasterize a codepoint into width * height R8 pixels. Fills the glyph's
+    // metrics at the layout font size; texture coordinates are left to the
+    // caller. Returns false if the font has no glyph for the codepoint.
+    bool rasterize(uint32_t codepoint, GlyphInfo& info, std::vector<unsigned char>& pixels,
+                   int& width, int& height);
+
+private:
+    int glyphIndex(uint32_t codepoint);
+
+    std::unique_ptr<stbtt_fontinfo> m_font;
+    std::unordered_map<uint32_t, int> m_glyphIndices;  // Codepoint to font glyph, 0 if absent
+    FontAtlasMode m_mode;
+    float m_scale;        // stb_truetype scale for the bake size
+    float m_metricScale;  // Bake size to layout size
+    int m_padding;        // SDF falloff around each glyph
+};
+
+/**
+ * @brief Rasterize printable ASCII from TrueType data with stb_truetype.
+ *
+ * Used by polarclock-fontbake, and at runtime when no baked atlas is found.
+ * Not available when the runtime is built without stb_truetype.
+ */
+bool bakeFontAtlas(const std::vector<unsigned char>& fontData, float fontSize,
+                   FontAtlasMode mode, FontAtlas& atlas);
+#endif
+
+} // namespace polarclock
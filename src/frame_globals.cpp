@@ -0,0 +1,88 @@
+#include "frame_globals.h"
+#include "gl_state.h"
+#include <cstring>
+
+namespace polarclock {
+
+FrameGlobals::FrameGlobals()
+    : m_block{}
+    , m_buffer(0)
+    , m_dirty(true)
+{
+    std::memcpy(m_block.projection, math::Mat4().data(), sizeof(m_block.projection));
+    m_block.pixelScale = 1.0f;
+    m_block.dpiScale = 1.0f;
+}
+
+FrameGlobals::~FrameGlobals() {
+    if (m_buffer) GLState::instance().deleteBuffer(m_buffer);
+}
+
+bool FrameGlobals::init() {
+    glGenBuffers(1, &m_buffer);
+    GLState::instance().bindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+
+    m_dirty = true;
+    return m_buffer != 0;
+}
+
+void FrameGlobals::setProjection(const math::Mat4& projection) {
+    if (std::memcmp(m_block.projection, projection.data(), sizeof(m_block.projection)) != 0) {
+        std::memcpy(m_block.projection, projection.data(), sizeof(m_block.projection));
+        m_dirty = true;
+    }
+}
+
+void FrameGlobals::setViewport(int width, int height) {
+    float w = static_cast<float>(width);
+    float h = static_cast<float>(height);
+    if (m_block.viewport[0] != w || m_block.viewport[1] != h) {
+        m_block.viewport[0] = w;
+        m_block.viewport[1] = h;
+        m_block.viewport[2] = width > 0 ? 1.0f / w : 0.0f;
+        m_block.viewport[3] = height > 0 ? 1.0f / h : 0.0f;
+        m_dirty = true;
+    }
+}
+
+void FrameGlobals::setTime(float seconds) {
+    if (m_block.time != seconds) {
+        m_block.time = seconds;
+        m_dirty = true;
+    }
+}
+
+void FrameGlobals::setPixelScale(float pixelScale) {
+    if (m_block.pixelScale != pixelScale) {
+        m_block.pixelScale = pixelScale;
+        m_dirty = true;
+    }
+}
+
+void FrameGlobals::setDpiScale(float dpiScale) {
+    if (m_block.dpiScale != dpiScale) {
+        m_block.dpiScale = dpiScale;
+        m_dirty = true;
+    }
+}
+
+/**
+ * @brief Rewrite the whole block if anything changed since the last upload.
+ *
+ * The block is 96 bytes, so there is nothing to gain from partial updates.
+ */
+void FrameGlobals::upload() {
+    if (!m_dirty || !m_buffer) return;
+
+    GLState::instance().bindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &m_block);
+    m_dirty = false;
+}
+
+void FrameGlobals::bind() {
+    upload();
+    GLState::instance().bindBufferBase(GL_UNIFORM_BUFFER, FRAME_GLOBALS_BINDING, m_buffer);
+}
+
+} // namespace polarclock
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "shader.h"
+#include "pcmath.h"
+
+namespace polarclock {
+
+// Uniform buffer binding point of the FrameGlobals block in every program
+constexpr GLuint FRAME_GLOBALS_BINDING = 1;
+
+/**
+ * @brief Per-frame values shared by every program through one uniform buffer.
+ *
+ * Mirrors the std140 FrameGlobals block in shaders/frame_globals.glsl, which
+ * Shader inserts into every vertex shader.
+ * Shader attaches that block to FRAME_GLOBALS_BINDING when it links, so
+ * programs never need these values set individually: the owner updates them
+ * on resize or once a frame, and upload() sends the block only if a value
+ * actually changed.
+ */
+class FrameGlobals {
+public:
+    FrameGlobals();
+    ~FrameGlobals();
+
+    bool init();
+
+    void setProjection(const math::Mat4& projection);
+    void setViewport(int width, int height);
+    void setTime(float seconds);
+    void setPixelScale(float pixelScale);
+    void setDpiScale(float dpiScale);
+
+    // Send changed values to the buffer
+    void upload();
+
+    // Upload, then attach the buffer to FRAME_GLOBALS_BINDING for later draws
+    void bind();
+
+    // Size of the buffer, which programs' FrameGlobals blocks must match
+    static size_t getBlockSize() { return sizeof(Block); }
+
+private:
+    // std140 layout of the FrameGlobals block in shaders/frame_globals.glsl
+    struct Block {
+        float projection[16];
+        float viewport[4];   // Width, height, 1 / width, 1 / height in pixels
+        float time;          // Seconds since the renderer started
+        float pixelScale;    // Framebuffer pixels per world unit
+        float dpiScale;      // Framebuffer pixels per logical pixel
+        float pad;
+    };
+
+    Block m_block;
+    GLuint m_buffer;
+    bool m_dirty;
+};
+
+} // namespace polarclock
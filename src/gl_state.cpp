@@ -0,0 +1,209 @@
+#include "gl_state.h"
+#include <algorithm>
+
+namespace polarclock {
+
+// Cached value meaning "whatever the context has", which never matches a real one
+static constexpr GLuint UNKNOWN = ~0u;
+
+GLState& GLState::instance() {
+    static GLState state;
+    return state;
+}
+
+GLState::GLState() {
+    reset();
+}
+
+void GLState::reset() {
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_arrayBuffer = UNKNOWN;
+    m_uniformBuffer = UNKNOWN;
+    std::fill(std::begin(m_uniformBindings), std::end(m_uniformBindings), UNKNOWN);
+    m_activeUnit = UNKNOWN;
+    std::fill(std::begin(m_textures2D), std::end(m_textures2D), UNKNOWN);
+    std::fill(std::begin(m_texturesArray), std::end(m_texturesArray), UNKNOWN);
+    m_framebuffer = UNKNOWN;
+    m_blend = UNKNOWN;
+    m_scissorTest = UNKNOWN;
+    m_blendSource = UNKNOWN;
+    m_blendDestination = UNKNOWN;
+    m_viewportKnown = false;
+    m_scissorKnown = false;
+}
+
+bool GLState::change(GLuint& cached, GLuint value) {
+    if (cached == value) {
+        ++m_stats.skipped;
+        return false;
+    }
+    cached = value;
+    ++m_stats.issued;
+    return true;
+}
+
+void GLState::useProgram(GLuint program) {
+    if (change(m_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLState::bindVertexArray(GLuint vertexArray) {
+    if (change(m_vertexArray, vertexArray)) {
+        glBindVertexArray(vertexArray);
+    }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint* cached = target == GL_ARRAY_BUFFER ? &m_arrayBuffer
+                   : target == GL_UNIFORM_BUFFER ? &m_uniformBuffer
+                   : nullptr;
+    if (!cached) {
+        ++m_stats.issued;
+        glBindBuffer(target, buffer);
+    } else if (change(*cached, buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+/**
+ * @brief Bind a buffer to an indexed binding point.
+ *
+ * Like GL, this also binds the buffer to the target's generic binding point.
+ */
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    if (target != GL_UNIFORM_BUFFER || index >= UNIFORM_BINDINGS) {
+        ++m_stats.issued;
+        glBindBufferBase(target, index, buffer);
+        if (target == GL_UNIFORM_BUFFER) m_uniformBuffer = buffer;
+        return;
+    }
+
+    if (change(m_uniformBindings[index], buffer)) {
+        glBindBufferBase(target, index, buffer);
+        m_uniformBuffer = buffer;
+    }
+}
+
+void GLState::activeTexture(GLenum unit) {
+    if (change(m_activeUnit, unit - GL_TEXTURE0)) {
+        glActiveTexture(unit);
+    }
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture) {
+    GLuint* cached = nullptr;
+    if (m_activeUnit < TEXTURE_UNITS) {
+        cached = target == GL_TEXTURE_2D ? &m_textures2D[m_activeUnit]
+               : target == GL_TEXTURE_2D_ARRAY ? &m_texturesArray[m_activeUnit]
+               : nullptr;
+    }
+
+    if (!cached) {
+        ++m_stats.issued;
+        glBindTexture(target, texture);
+    } else if (change(*cached, texture)) {
+        glBindTexture(target, texture);
+    }
+}
+
+void GLState::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    if (target != GL_FRAMEBUFFER) {
+        // Draw or read only: the combined binding is no longer known
+        m_framebuffer = UNKNOWN;
+        ++m_stats.issued;
+        glBindFramebuffer(target, framebuffer);
+    } else if (change(m_framebuffer, framebuffer)) {
+        glBindFramebuffer(target, framebuffer);
+    }
+}
+
+void GLState::setEnabled(GLenum capability, bool enabled) {
+    GLuint* cached = capability == GL_BLEND ? &m_blend
+                   : capability == GL_SCISSOR_TEST ? &m_scissorTest
+                   : nullptr;
+    if (cached && !change(*cached, enabled ? GL_TRUE : GL_FALSE)) {
+        return;
+    }
+    if (!cached) {
+        ++m_stats.issued;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination) {
+    if (m_blendSource == source && m_blendDestination == destination) {
+        ++m_stats.skipped;
+        return;
+    }
+    m_blendSource = source;
+    m_blendDestination = destination;
+    ++m_stats.issued;
+    glBlendFunc(source, destination);
+}
+
+void GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (m_viewportKnown && m_viewport.x == x && m_viewport.y == y &&
+        m_viewport.width == width && m_viewport.height == height) {
+        ++m_stats.skipped;
+        return;
+    }
+    m_viewport = { x, y, width, height };
+    m_viewportKnown = true;
+    ++m_stats.issued;
+    glViewport(x, y, width, height);
+}
+
+void GLState::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (m_scissorKnown && m_scissor.x == x && m_scissor.y == y &&
+        m_scissor.width == width && m_scissor.height == height) {
+        ++m_stats.skipped;
+        return;
+    }
+    m_scissor = { x, y, width, height };
+    m_scissorKnown = true;
+    ++m_stats.issued;
+    glScissor(x, y, width, height);
+}
+
+// Deleting a bound object reverts its bindings in the current context to 0
+
+void GLState::deleteProgram(GLuint program) {
+    // A program in use is only flagged for deletion and stays current
+    glDeleteProgram(program);
+}
+
+void GLState::deleteVertexArray(GLuint vertexArray) {
+    if (m_vertexArray == vertexArray) m_vertexArray = 0;
+    glDeleteVertexArrays(1, &vertexArray);
+}
+
+void GLState::deleteBuffer(GLuint buffer) {
+    if (m_arrayBuffer == buffer) m_arrayBuffer = 0;
+    if (m_uniformBuffer == buffer) m_uniformBuffer = 0;
+    for (GLuint& binding : m_uniformBindings) {
+        if (binding == buffer) binding = 0;
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLState::deleteTexture(GLuint texture) {
+    for (int unit = 0; unit < TEXTURE_UNITS; ++unit) {
+        if (m_textures2D[unit] == texture) m_textures2D[unit] = 0;
+        if (m_texturesArray[unit] == texture) m_texturesArray[unit] = 0;
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void GLState::deleteFramebuffer(GLuint framebuffer) {
+    if (m_framebuffer == framebuffer) m_framebuffer = 0;
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+} // namespace polarclock
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "shader.h"
+#include <cstdint>
+
+namespace polarclock {
+
+// GL state calls made and skipped as no-ops since the last reset
+struct GLStateStats {
+    uint64_t issued = 0;
+    uint64_t skipped = 0;
+};
+
+/**
+ * @brief Shadow copy of the GL binding and fixed-function state the app uses.
+ *
+ * Every bind, enable and viewport change goes through here, so a call that
+ * would set what is already set is dropped before it reaches the driver
+ * (or, under WebGL, crosses into JavaScript). This only holds as long as
+ * nothing bypasses it: objects that may be bound must be deleted through
+ * the delete* functions, which also clear any binding GL drops with them.
+ *
+ * Tracked: program, VAO, array and uniform buffers (including indexed
+ * uniform bindings), 2D and 2D array textures per unit, the active unit,
+ * framebuffer, blend and scissor enables, blend function, viewport and
+ * scissor box. Targets outside that set are passed straight through.
+ */
+class GLState {
+public:
+    static GLState& instance();
+
+    // Forget everything, e.g. after the context was recreated
+    void reset();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void activeTexture(GLenum unit);
+    void bindTexture(GLenum target, GLuint texture);
+    void bindFramebuffer(GLenum target, GLuint framebuffer);
+    void setEnabled(GLenum capability, bool enabled);
+    void blendFunc(GLenum source, GLenum destination);
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    void deleteProgram(GLuint program);
+    void deleteVertexArray(GLuint vertexArray);
+    void deleteBuffer(GLuint buffer);
+    void deleteTexture(GLuint texture);
+    void deleteFramebuffer(GLuint framebuffer);
+
+    const GLStateStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = GLStateStats(); }
+
+    static constexpr int TEXTURE_UNITS = 4;
+    static constexpr int UNIFORM_BINDINGS = 4;
+
+private:
+    GLState();
+    GLState(const GLState&) = delete;
+    GLState& operator=(const GLState&) = delete;
+
+    // True (and counted as issued) if value differs from cached, which is updated
+    bool change(GLuint& cached, GLuint value);
+
+    struct Rect {
+        GLint x, y;
+        GLsizei width, height;
+    };
+
+    GLuint m_program;
+    GLuint m_vertexArray;
+    GLuint m_arrayBuffer;
+    GLuint m_uniformBuffer;
+    GLuint m_uniformBindings[UNIFORM_BINDINGS];
+    GLuint m_activeUnit;                     // 0-based
+    GLuint m_textures2D[TEXTURE_UNITS];
+    GLuint m_texturesArray[TEXTURE_UNITS];
+    GLuint m_framebuffer;
+    GLuint m_blend;                          // GL_TRUE, GL_FALSE or UNKNOWN
+    GLuint m_scissorTest;
+    GLuint m_blendSource;
+    GLuint m_blendDestination;
+    Rect m_viewport;
+    Rect m_scissor;
+    bool m_viewportKnown;
+    bool m_scissorKnown;
+
+    GLStateStats m_stats;
+};
+
+} // namespace polarclock
@@ -0,0 +1,311 @@
+#include "glyph_cache.h"
+#include "gl_state.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace polarclock {
+
+GlyphCache::GlyphCache()
+    : m_mode(FontAtlasMode::Bitmap)
+    , m_pageSize(0)
+    , m_frame(0)
+    , m_slotsChanged(false)
+    , m_warnedFull(false)
+#ifndef POLARCLOCK_NO_FONT_RASTER
+    , m_canRasterize(false)
+#endif
+    , m_texture(0)
+    , m_textureLayers(0)
+{
+}
+
+GlyphCache::~GlyphCache() {
+    if (m_texture) GLState::instance().deleteTexture(m_texture);
+}
+
+/**
+ * @brief Reset the cache for a font and atlas mode.
+ *
+ * A baked atlas whose size matches the mode's page size is copied into a
+ * pinned first page and all of its glyphs become resident.
+ *
+ * @param mode     Bitmap or SDF.
+ * @param fontSize Layout font size in pixels.
+ * @param baked    Atlas baked by polarclock-fontbake, or nullptr.
+ * @param fontData TrueType data to rasterize misses from, or nullptr.
+ * @return true if there is at least one source of glyphs, false otherwise.
+ */
+bool GlyphCache::init(FontAtlasMode mode, float fontSize, const FontAtlas* baked,
+                      const std::vector<unsigned char>* fontData) {
+    m_mode = mode;
+    m_pageSize = fontAtlasPageSize(mode);
+    m_pages.clear();
+    m_slots.assign(MAX_GLYPHS, CachedGlyph());
+    m_freeSlots.clear();
+    for (int i = MAX_GLYPHS - 1; i >= 0; --i) {
+        m_freeSlots.push_back(i);
+    }
+    m_lookup.clear();
+    m_slotsChanged = true;
+    m_warnedFull = false;
+    m_textureLayers = 0;
+
+    if (baked && baked->width == m_pageSize && baked->height == m_pageSize) {
+        int index = addPage();
+        Page& page = m_pages[index];
+        page.pixels = baked->pixels;
+        page.pinned = true;
+
+        for (const FontAtlas::Glyph& glyph : baked->glyphs) {
+            if (m_freeSlots.empty()) break;
+            int slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            m_slots[slot].codepoint = glyph.codepoint;
+            m_slots[slot].info = glyph.info;
+            m_slots[slot].page = index;
+            page.slots.push_back(slot);
+            m_lookup[glyph.codepoint] = slot;
+        }
+    } else if (baked) {
+        std::cerr << "Ignoring baked font atlas of size " << baked->width << "x" << baked->height << std::endl;
+    }
+
+#ifndef POLARCLOCK_NO_FONT_RASTER
+    m_canRasterize = fontData && m_rasterizer.init(*fontData, fontSize, mode);
+    if (m_canRasterize) return true;
+#else
+    (void)fontSize;
+    (void)fontData;
+#endif
+
+    if (m_pages.empty()) {
+        std::cerr << "No font atlas and no font to rasterize glyphs from" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Look up a glyph, rasterizing and packing it on a miss.
+ *
+ * Hits are a single hash lookup. Every hit or insert marks the glyph's page
+ * as used this frame, which protects it from eviction until endFrame().
+ */
+const CachedGlyph* GlyphCache::acquire(uint32_t codepoint) {
+    auto it = m_lookup.find(codepoint);
+    if (it == m_lookup.end()) {
+        return insert(codepoint);
+    }
+    if (it->second < 0) {
+        return nullptr;
+    }
+
+    CachedGlyph& glyph = m_slots[it->second];
+    m_pages[glyph.page].lastUsed = m_frame;
+    return &glyph;
+}
+
+bool GlyphCache::isMissing(uint32_t codepoint) const {
+    auto it = m_lookup.find(codepoint);
+    return it != m_lookup.end() && it->second < 0;
+}
+
+bool GlyphCache::takeSlotsChanged() {
+    bool changed = m_slotsChanged;
+    m_slotsChanged = false;
+    return changed;
+}
+
+/**
+ * @brief Rasterize a codepoint into a free slot and page.
+ *
+ * Codepoints that cannot be rasterized are remembered as missing so they
+ * are not retried. A full cache is not remembered: the glyph is dropped for
+ * this frame only.
+ */
+const CachedGlyph* GlyphCache::insert(uint32_t codepoint) {
+#ifndef POLARCLOCK_NO_FONT_RASTER
+    if (m_canRasterize) {
+        GlyphInfo info;
+        int width = 0, height = 0;
+        if (!m_rasterizer.rasterize(codepoint, info, m_scratch, width, height)) {
+            std::cerr << "Font has no glyph for U+" << std::hex << std::uppercase << codepoint
+                      << std::dec << std::nouppercase << std::endl;
+            m_lookup[codepoint] = -1;
+            return nullptr;
+        }
+
+        int x = 0, y = 0;
+        int index = -1;
+        if (!m_freeSlots.empty() || evictPage() >= 0) {
+            index = allocate(width, height, x, y);
+        }
+        if (index < 0) {
+            if (!m_warnedFull) {
+                std::cerr << "Glyph cache full; dropping glyphs until pages are released" << std::endl;
+                m_warnedFull = true;
+            }
+            return nullptr;
+        }
+
+        Page& page = m_pages[index];
+        for (int row = 0; row < height; ++row) {
+            std::memcpy(&page.pixels[(y + row) * m_pageSize + x], &m_scratch[row * width], width);
+        }
+        markDirty(page, x, y, width, height);
+
+        info.x0 = static_cast<float>(x) / m_pageSize;
+        info.y0 = static_cast<float>(y) / m_pageSize;
+        info.x1 = static_cast<float>(x + width) / m_pageSize;
+        info.y1 = static_cast<float>(y + height) / m_pageSize;
+
+        int slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        CachedGlyph& glyph = m_slots[slot];
+        glyph.codepoint = codepoint;
+        glyph.info = info;
+        glyph.page = index;
+        page.slots.push_back(slot);
+        page.lastUsed = m_frame;
+        m_lookup[codepoint] = slot;
+        m_slotsChanged = true;
+        return &glyph;
+    }
+#endif
+
+    m_lookup[codepoint] = -1;
+    return nullptr;
+}
+
+/**
+ * @brief Find room for a glyph bitmap, adding or evicting a page if needed.
+ *
+ * @return The page index with the glyph's top-left texel in x, y, or -1.
+ */
+int GlyphCache::allocate(int width, int height, int& x, int& y) {
+    int index = -1;
+    for (size_t i = 0; i < m_pages.size() && index < 0; ++i) {
+        if (!m_pages[i].pinned && m_pages[i].packer.pack(width + GLYPH_SPACING, height + GLYPH_SPACING, x, y)) {
+            index = static_cast<int>(i);
+        }
+    }
+
+    if (index < 0) {
+        int fresh = static_cast<int>(m_pages.size()) < MAX_PAGES ? addPage() : evictPage();
+        if (fresh < 0 || !m_pages[fresh].packer.pack(width + GLYPH_SPACING, height + GLYPH_SPACING, x, y)) {
+            return -1;
+        }
+        index = fresh;
+    }
+
+    x += GLYPH_SPACING;
+    y += GLYPH_SPACING;
+    return index;
+}
+
+/**
+ * @brief Clear the least recently used page not touched this frame.
+ *
+ * @return The emptied page, or -1 if every unpinned page is in use.
+ */
+int GlyphCache::evictPage() {
+    int victim = -1;
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        const Page& page = m_pages[i];
+        if (page.pinned || page.lastUsed == m_frame || page.slots.empty()) continue;
+        if (victim < 0 || page.lastUsed < m_pages[victim].lastUsed) {
+            victim = static_cast<int>(i);
+        }
+    }
+
+    if (victim >= 0) {
+        clearPage(victim);
+    }
+    return victim;
+}
+
+int GlyphCache::addPage() {
+    Page page;
+    page.pixels.assign(m_pageSize * m_pageSize, 0);
+    page.packer.reset(m_pageSize - GLYPH_SPACING, m_pageSize - GLYPH_SPACING);
+    page.lastUsed = m_frame;
+    m_pages.push_back(std::move(page));
+    return static_cast<int>(m_pages.size()) - 1;
+}
+
+void GlyphCache::clearPage(int index) {
+    Page& page = m_pages[index];
+    for (int slot : page.slots) {
+        m_lookup.erase(m_slots[slot].codepoint);
+        m_slots[slot] = CachedGlyph();
+        m_freeSlots.push_back(slot);
+    }
+    page.slots.clear();
+    std::fill(page.pixels.begin(), page.pixels.end(), 0);
+    page.packer.reset(m_pageSize - GLYPH_SPACING, m_pageSize - GLYPH_SPACING);
+    markDirty(page, 0, 0, m_pageSize, m_pageSize);
+    m_slotsChanged = true;
+}
+
+void GlyphCache::markDirty(Page& page, int x, int y, int width, int height) {
+    if (width <= 0 || height <= 0) return;
+
+    if (page.dirtyX0 >= page.dirtyX1) {
+        page.dirtyX0 = x;
+        page.dirtyY0 = y;
+        page.dirtyX1 = x + width;
+        page.dirtyY1 = y + height;
+        return;
+    }
+    page.dirtyX0 = std::min(page.dirtyX0, x);
+    page.dirtyY0 = std::min(page.dirtyY0, y);
+    page.dirtyX1 = std::max(page.dirtyX1, x + width);
+    page.dirtyY1 = std::max(page.dirtyY1, y + height);
+}
+
+/**
+ * @brief Upload the dirty part of each page.
+ *
+ * The texture array is reallocated, and every page re-sent, only when a
+ * page is added. Otherwise each page sends the bounding box of the glyphs
+ * packed since the last upload with one glTexSubImage3D, reading straight
+ * out of the page's CPU copy via GL_UNPACK_ROW_LENGTH.
+ */
+void GlyphCache::upload() {
+    if (m_pages.empty()) return;
+
+    if (!m_texture) {
+        glGenTextures(1, &m_texture);
+    }
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+
+    if (m_textureLayers != static_cast<int>(m_pages.size())) {
+        m_textureLayers = static_cast<int>(m_pages.size());
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, m_pageSize, m_pageSize, m_textureLayers,
+                     0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        for (Page& page : m_pages) {
+            page.dirtyX0 = page.dirtyX1 = 0;
+            markDirty(page, 0, 0, m_pageSize, m_pageSize);
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, m_pageSize);
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        Page& page = m_pages[i];
+        if (page.dirtyX0 >= page.dirtyX1) continue;
+
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, page.dirtyX0, page.dirtyY0, static_cast<GLint>(i),
+                        page.dirtyX1 - page.dirtyX0, page.dirtyY1 - page.dirtyY0, 1,
+                        GL_RED, GL_UNSIGNED_BYTE, &page.pixels[page.dirtyY0 * m_pageSize + page.dirtyX0]);
+        page.dirtyX0 = page.dirtyX1 = 0;
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+} // namespace polarclock
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "shader.h"
+#include "font_atlas.h"
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace polarclock {
+
+// A glyph resident in the cache
+struct CachedGlyph {
+    uint32_t codepoint = 0;
+    GlyphInfo info;   // Texture coordinates are within `page`
+    int page = -1;    // Texture array layer, -1 if the slot is free
+};
+
+/**
+ * @brief Glyphs rasterized on first use into a paged texture array.
+ *
+ * A baked atlas, if there is one, becomes a pinned first page. Codepoints it
+ * does not cover are rasterized when first requested and skyline-packed into
+ * further pages, which are added up to MAX_PAGES. Each page keeps a CPU copy
+ * and a dirty rectangle, so upload() only sends newly packed texels.
+ *
+ * When no page has room, the least recently used page that has not been
+ * touched this frame is cleared and reused. Glyphs also occupy one of
+ * MAX_GLYPHS slots, which index the glyph table of text_arc.vert; running
+ * out of slots evicts a page the same way.
+ */
+class GlyphCache {
+public:
+    GlyphCache();
+    ~GlyphCache();
+
+    // Drop all glyphs and start over for a font and atlas mode. baked may be
+    // null; without POLARCLOCK_NO_FONT_RASTER, fontData (which must stay
+    // alive) is used to rasterize anything the baked atlas lacks.
+    bool init(FontAtlasMode mode, float fontSize, const FontAtlas* baked,
+              const std::vector<unsigned char>* fontData);
+
+    // Find a codepoint's glyph, rasterizing it on a miss. Returns nullptr if
+    // the font cannot provide it or every page is in use this frame.
+    const CachedGlyph* acquire(uint32_t codepoint);
+
+    // True if the codepoint can never be cached (no rasterizer and not baked)
+    bool isMissing(uint32_t codepoint) const;
+
+    // Send dirty page rectangles to the texture; call before drawing
+    void upload();
+
+    // Glyphs acquired after this may evict pages used before it
+    void endFrame() { ++m_frame; }
+
+    // Glyph table access for text_arc.vert; slot contents change on misses
+    const CachedGlyph& slot(int index) const { return m_slots[index]; }
+    int slotIndex(const CachedGlyph* glyph) const { return static_cast<int>(glyph - m_slots.data()); }
+    bool takeSlotsChanged();
+
+    GLuint getTexture() const { return m_texture; }
+
+    static constexpr int MAX_PAGES = 4;
+    static constexpr int MAX_GLYPHS = 256;
+
+private:
+    struct Page {
+        std::vector<unsigned char> pixels;  // CPU copy, pageSize * pageSize
+        SkylinePacker packer;
+        std::vector<int> slots;             // Glyphs living on this page
+        uint32_t lastUsed = 0;              // Frame of the last acquire
+        bool pinned = false;                // Baked page, never evicted
+        int dirtyX0 = 0, dirtyY0 = 0, dirtyX1 = 0, dirtyY1 = 0;  // Empty if x0 >= x1
+    };
+
+    const CachedGlyph* insert(uint32_t codepoint);
+    int allocate(int width, int height, int& x, int& y);
+    int evictPage();
+    int addPage();
+    void clearPage(int index);
+    void markDirty(Page& page, int x, int y, int width, int height);
+
+    FontAtlasMode m_mode;
+    int m_pageSize;
+    std::vector<Page> m_pages;
+    std::vector<CachedGlyph> m_slots;
+    std::vector<int> m_freeSlots;
+    std::unordered_map<uint32_t, int> m_lookup;  // Codepoint to slot
+    uint32_t m_frame;
+    bool m_slotsChanged;
+    bool m_warnedFull;  // "Cache full" reported since init
+
+#ifndef POLARCLOCK_NO_FONT_RASTER
+    GlyphRasterizer m_rasterizer;
+    bool m_canRasterize;
+    std::vector<unsigned char> m_scratch;  // Last rasterized bitmap
+#endif
+
+    GLuint m_texture;
+    int m_textureLayers;  // Layers allocated in m_texture
+};
+
+} // namespace polarclock
@@ -0,0 +1,241 @@
+#include "label_cache.h"
+#include "gl_state.h"
+#include <iostream>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+namespace polarclock {
+
+LabelCache::LabelCache()
+    : m_stream(nullptr)
+    , m_vao(0)
+    , m_texture(0)
+    , m_framebuffer(0)
+{
+}
+
+LabelCache::~LabelCache() {
+    if (m_vao) GLState::instance().deleteVertexArray(m_vao);
+    if (m_texture) GLState::instance().deleteTexture(m_texture);
+    if (m_framebuffer) GLState::instance().deleteFramebuffer(m_framebuffer);
+}
+
+/**
+ * @brief Create the slice texture array, its framebuffer and the quad VAO.
+ *
+ * @return true if the slices can be rendered to, false otherwise.
+ */
+bool LabelCache::init(StreamBuffer& stream) {
+    m_stream = &stream;
+
+    if (!m_shader.submitEmbedded(EmbeddedShader::LabelVert, EmbeddedShader::LabelFrag)) {
+        return false;
+    }
+
+    if (!m_globals.init()) {
+        return false;
+    }
+
+    glGenTextures(1, &m_texture);
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, SLICE_WIDTH, SLICE_HEIGHT, MAX_LABELS,
+                 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_texture, 0, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Label cache framebuffer incomplete: 0x" << std::hex << status << std::dec << std::endl;
+        GLState::instance().deleteFramebuffer(m_framebuffer);
+        m_framebuffer = 0;
+        return false;
+    }
+
+    // Same vertex layout as batched text: position, UV and layer, RGBA8 color
+    glGenVertexArrays(1, &m_vao);
+    GLState::instance().bindVertexArray(m_vao);
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_stream->getBuffer());
+
+    const GLsizei stride = sizeof(TextVertex);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TextVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TextVertex, u));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(TextVertex, color));
+    glEnableVertexAttribArray(2);
+
+    GLState::instance().bindVertexArray(0);
+
+    return true;
+}
+
+/**
+ * @brief Finish the label program if the driver is already done with it.
+ *
+ * Does not block with KHR_parallel_shader_compile; waitForPrograms() then
+ * only waits for what is still pending.
+ */
+void LabelCache::pollPrograms() {
+    m_shader.poll();
+}
+
+bool LabelCache::waitForPrograms() {
+    if (!m_shader.wait()) {
+        return false;
+    }
+
+    m_shader.use();
+    m_shader.setInt(m_shader.uniform("u_labels"), 0);
+    return true;
+}
+
+/**
+ * @brief Render a label into its slice if the cached one no longer matches.
+ *
+ * The label is laid out clockwise around 12 o'clock, where it is widest
+ * horizontally. Its bounding box covers the arc span plus one font size of
+ * glyph extent on every side, and is rendered at the screen's pixel density
+ * (less if it would not fit in a slice). Text is drawn white, so the R8
+ * slice ends up holding coverage.
+ *
+ * @param index      Label slot, one per ring.
+ * @param text       Renderer used to draw the label; must have nothing queued.
+ * @param label      Label text.
+ * @param radius     Baseline radius in world units.
+ * @param scale      Text scale passed to renderTextOnArc.
+ * @param pixelScale Screen pixels per world unit.
+ * @return true if the slice holds the label, false if it cannot be cached.
+ */
+bool LabelCache::update(size_t index, TextRenderer& text, const std::string& label,
+                        float radius, float scale, float pixelScale) {
+    if (index >= MAX_LABELS || !m_framebuffer) return false;
+
+    Slice& slice = m_slices[index];
+    if (slice.valid && slice.text == label && slice.radius == radius &&
+        slice.scale == scale && slice.pixelScale == pixelScale) {
+        return true;
+    }
+
+    float width = text.layout(label).width * scale;
+    float extent = text.getFontSize() * scale;
+    float outer = radius + extent;
+    float inner = std::max(radius - extent, 0.0f);
+    float halfSpan = (width / 2.0f + extent) / std::max(inner, extent);
+
+    // Box around the arc band between inner and outer, symmetric about the y axis
+    float halfWidth = halfSpan >= math::PI / 2.0f ? outer : outer * std::sin(halfSpan);
+    float bottom = halfSpan >= math::PI ? -outer
+                 : std::min(inner * std::cos(halfSpan), outer * std::cos(halfSpan));
+    float boxWidth = 2.0f * halfWidth;
+    float boxHeight = outer - bottom;
+
+    float density = std::min(pixelScale, std::min(SLICE_WIDTH / boxWidth, SLICE_HEIGHT / boxHeight));
+    int pixelWidth = std::min(static_cast<int>(std::ceil(boxWidth * density)), SLICE_WIDTH);
+    int pixelHeight = std::min(static_cast<int>(std::ceil(boxHeight * density)), SLICE_HEIGHT);
+
+    slice.x0 = -halfWidth;
+    slice.y0 = bottom;
+    slice.x1 = slice.x0 + pixelWidth / density;
+    slice.y1 = slice.y0 + pixelHeight / density;
+    slice.u1 = static_cast<float>(pixelWidth) / SLICE_WIDTH;
+    slice.v1 = static_cast<float>(pixelHeight) / SLICE_HEIGHT;
+
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_texture, 0, static_cast<GLint>(index));
+    GLState::instance().viewport(0, 0, pixelWidth, pixelHeight);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Slices get their own globals so the screen's block is left untouched
+    m_globals.setProjection(math::Mat4::ortho(slice.x0, slice.x1, slice.y0, slice.y1, -1.0f, 1.0f));
+    m_globals.setViewport(pixelWidth, pixelHeight);
+    m_globals.setPixelScale(density);
+    m_globals.bind();
+
+    text.renderTextOnArc(label, radius, math::PI / 2.0f, scale, math::Vec3(1.0f, 1.0f, 1.0f), true, 1.0f);
+    text.flush();
+
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    slice.text = label;
+    slice.radius = radius;
+    slice.scale = scale;
+    slice.pixelScale = pixelScale;
+    slice.valid = true;
+    return true;
+}
+
+void LabelCache::invalidate() {
+    for (Slice& slice : m_slices) {
+        slice.valid = false;
+    }
+}
+
+/**
+ * @brief Queue a cached label as one quad rotated about the origin.
+ */
+void LabelCache::submit(RenderGraph& graph, RenderPass pass, size_t index, float centerAngle,
+                        const math::Vec3& color, float alpha) {
+    const Slice& slice = m_slices[index];
+    math::Affine2 rotation = math::Affine2::rotate(centerAngle - math::PI / 2.0f);
+
+    math::Vec2 bl = rotation.transform(math::Vec2(slice.x0, slice.y0));
+    math::Vec2 tl = rotation.transform(math::Vec2(slice.x0, slice.y1));
+    math::Vec2 tr = rotation.transform(math::Vec2(slice.x1, slice.y1));
+    math::Vec2 br = rotation.transform(math::Vec2(slice.x1, slice.y0));
+
+    float layer = static_cast<float>(index);
+    uint8_t rgba[4] = {
+        static_cast<uint8_t>(math::clamp(color.x, 0.0f, 1.0f) * 255.0f + 0.5f),
+        static_cast<uint8_t>(math::clamp(color.y, 0.0f, 1.0f) * 255.0f + 0.5f),
+        static_cast<uint8_t>(math::clamp(color.z, 0.0f, 1.0f) * 255.0f + 0.5f),
+        static_cast<uint8_t>(math::clamp(alpha, 0.0f, 1.0f) * 255.0f + 0.5f)
+    };
+
+    // Slices are rendered bottom-up, so v = 0 is the bottom of the box
+    const TextVertex quad[6] = {
+        { bl.x, bl.y, 0.0f,     0.0f,     layer, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+        { tl.x, tl.y, 0.0f,     slice.v1, layer, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+        { tr.x, tr.y, slice.u1, slice.v1, layer, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+
+        { bl.x, bl.y, 0.0f,     0.0f,     layer, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+        { tr.x, tr.y, slice.u1, slice.v1, layer, { rgba[0], rgba[1], rgba[2], rgba[3] } },
+        { br.x, br.y, slice.u1, 0.0f,     layer, { rgba[0], rgba[1], rgba[2], rgba[3] } }
+    };
+
+    DrawState state;
+    state.program = m_shader.getProgram();
+    state.texture = m_texture;
+    graph.submit(pass, state, *this, static_cast<uint32_t>(m_submitted.size() / 6));
+    m_submitted.insert(m_submitted.end(), quad, quad + 6);
+}
+
+void LabelCache::drawBatch(const uint32_t* items, size_t count) {
+    m_batch.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const TextVertex* quad = &m_submitted[items[i] * 6];
+        m_batch.insert(m_batch.end(), quad, quad + 6);
+    }
+    if (m_batch.empty()) return;
+
+    const GLsizei stride = sizeof(TextVertex);
+    GLintptr offset = m_stream->upload(m_batch.data(), m_batch.size() * stride, stride);
+    if (offset == StreamBuffer::UPLOAD_FAILED) return;
+
+    m_shader.use();
+
+    GLState::instance().activeTexture(GL_TEXTURE0);
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    GLState::instance().bindVertexArray(m_vao);
+
+    glDrawArrays(GL_TRIANGLES, static_cast<GLint>(offset / stride), static_cast<GLsizei>(m_batch.size()));
+}
+
+} // namespace polarclock
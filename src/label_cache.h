@@ -0,0 +1,82 @@
+#pragma once
+
+#include "shader.h"
+#include "frame_globals.h"
+#include "stream_buffer.h"
+#include "text_renderer.h"
+#include "render_graph.h"
+#include "pcmath.h"
+#include <string>
+#include <vector>
+
+namespace polarclock {
+
+/**
+ * @brief Curved ring labels rendered once into offscreen texture slices.
+ *
+ * Each label owns one layer of an R8 texture array holding its coverage,
+ * rendered through TextRenderer with the label centered at 12 o'clock.
+ * Because a curved label only rotates about the origin as its arc grows,
+ * drawing it is then a single textured quad rotated to the arc end, tinted
+ * with the label color. A slice is re-rendered only when its text, radius,
+ * text scale or the pixel density changes.
+ */
+class LabelCache : public DrawBatcher {
+public:
+    LabelCache();
+    ~LabelCache();
+
+    // Create the slices and submit the label program; call waitForPrograms()
+    // before use
+    bool init(StreamBuffer& stream);
+    void pollPrograms();
+    bool waitForPrograms();
+
+    // Make sure slice `index` holds this label, rendering it if its key
+    // changed. Binds an offscreen framebuffer and its own frame globals, so
+    // call before drawing the frame and restore the viewport and globals
+    // afterwards. False if the label cannot be cached and has to be drawn
+    // directly.
+    bool update(size_t index, TextRenderer& text, const std::string& label,
+                float radius, float scale, float pixelScale);
+
+    // Drop every slice, e.g. after the font atlas changed
+    void invalidate();
+
+    // Queue slice `index`, rotated so the label is centered at centerAngle,
+    // as a packet in `graph`. All labels in a batch are drawn in one call.
+    void submit(RenderGraph& graph, RenderPass pass, size_t index, float centerAngle,
+                const math::Vec3& color, float alpha);
+    void drawBatch(const uint32_t* items, size_t count) override;
+    void clearSubmitted() override { m_submitted.clear(); }
+
+    static constexpr size_t MAX_LABELS = 8;
+
+private:
+    struct Slice {
+        std::string text;
+        float radius = 0.0f;
+        float scale = 0.0f;
+        float pixelScale = 0.0f;
+        bool valid = false;
+        float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;  // World-space box at 12 o'clock
+        float u1 = 0.0f, v1 = 0.0f;                          // Used part of the layer
+    };
+
+    StreamBuffer* m_stream;  // Shared per-frame vertex storage, owned by Renderer
+
+    Shader m_shader;
+    FrameGlobals m_globals;  // Projection onto the slice being rendered
+    GLuint m_vao;
+    GLuint m_texture;
+    GLuint m_framebuffer;
+
+    Slice m_slices[MAX_LABELS];
+    std::vector<TextVertex> m_submitted;  // Six vertices per submitted label
+    std::vector<TextVertex> m_batch;      // Quads of the batch being drawn
+
+    static constexpr int SLICE_WIDTH = 1024;
+    static constexpr int SLICE_HEIGHT = 256;
+};
+
+} // namespace polarclock
@@ -1,9 +1,15 @@
 #include "platform/platform.h"
 #include "renderer.h"
+#include "program_cache.h"
+#include "gl_state.h"
 #include "polar_clock.h"
 
 #include <iostream>
 #include <memory>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
 
 int main() {
     // Create platform-specific implementation
@@ -21,12 +27,56 @@ int main() {
     int width, height;
     platform->getFramebufferSize(width, height);
 
+    // Reuse linked shader programs from earlier launches unless told not to
+    const char* programCache = std::getenv("POLARCLOCK_PROGRAM_CACHE");
+    std::string cacheDirectory = platform->getCacheDirectory();
+    if (!cacheDirectory.empty() && (!programCache || std::strcmp(programCache, "0") != 0)) {
+        polarclock::ProgramCache::instance().setDirectory(cacheDirectory + "/programs");
+    }
+
     std::cout << "Initializing renderer..." << std::endl;
+    auto initStart = std::chrono::steady_clock::now();
     if (!renderer.init(width, height)) {
         std::cerr << "Failed to initialize renderer" << std::endl;
         return -1;
     }
-    std::cout << "Renderer initialized successfully" << std::endl;
+    const polarclock::ProgramCache& cache = polarclock::ProgramCache::instance();
+    std::cout << "Renderer initialized successfully in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initStart).count()
+              << " ms (" << cache.getHits() << " programs from cache, " << cache.getMisses() << " compiled)"
+              << std::endl;
+
+    // Select the arc engine at runtime so frame times can be A/B compared
+    if (const char* arcMode = std::getenv("POLARCLOCK_ARC_MODE")) {
+        if (std::strcmp(arcMode, "sdf") == 0) {
+            renderer.setArcMode(polarclock::ArcRenderMode::Sdf);
+        } else if (std::strcmp(arcMode, "instanced") == 0) {
+            renderer.setArcMode(polarclock::ArcRenderMode::Instanced);
+        } else {
+            renderer.setArcMode(polarclock::ArcRenderMode::Mesh);
+        }
+        std::cout << "Arc mode: " << arcMode << std::endl;
+    }
+    if (const char* compact = std::getenv("POLARCLOCK_ARC_COMPACT")) {
+        renderer.setArcCompactVertices(std::strcmp(compact, "1") == 0);
+    }
+    if (const char* textSdf = std::getenv("POLARCLOCK_TEXT_SDF")) {
+        renderer.setTextAtlasMode(std::strcmp(textSdf, "1") == 0
+            ? polarclock::FontAtlasMode::Sdf : polarclock::FontAtlasMode::Bitmap);
+    }
+
+    // Redraw every frame instead of sleeping until the clock visibly changes
+    const char* continuousEnv = std::getenv("POLARCLOCK_CONTINUOUS");
+    bool continuous = continuousEnv && std::strcmp(continuousEnv, "1") == 0;
+
+    // Periodically report how many uniform uploads were skipped as redundant
+    const char* uniformStatsEnv = std::getenv("POLARCLOCK_UNIFORM_STATS");
+    bool uniformStats = uniformStatsEnv && std::strcmp(uniformStatsEnv, "1") == 0;
+
+    // ... and how many GL state changes
+    const char* glStatsEnv = std::getenv("POLARCLOCK_GL_STATS");
+    bool glStats = glStatsEnv && std::strcmp(glStatsEnv, "1") == 0;
+    int statsFrames = 0;
 
     // Initialize clock
     polarclock::PolarClock clock;
@@ -44,6 +94,7 @@ int main() {
         int newWidth, newHeight;
         platform->getFramebufferSize(newWidth, newHeight);
         renderer.resize(newWidth, newHeight);
+        renderer.setContentScale(platform->getContentScale());
         // if (newWidth != lastWidth || newHeight != lastHeight) {
         //     std::cout << "Size updated to " << newWidth << " " << newHeight << std::endl;
         //     lastWidth = newWidth;
@@ -54,6 +105,25 @@ int main() {
         // Update and render
         clock.update(deltaTime);
         renderer.render(clock);
+        if (!continuous) {
+            platform->setFrameDelay(renderer.getTimeUntilChange(clock));
+        }
+
+        if ((uniformStats || glStats) && ++statsFrames == 600) {
+            if (uniformStats) {
+                const polarclock::UniformUploadStats& stats = polarclock::Shader::getUploadStats();
+                std::cout << "Uniform uploads over " << statsFrames << " frames: " << stats.issued
+                          << " issued, " << stats.skipped << " skipped" << std::endl;
+                polarclock::Shader::resetUploadStats();
+            }
+            if (glStats) {
+                const polarclock::GLStateStats& stats = polarclock::GLState::instance().getStats();
+                std::cout << "GL state changes over " << statsFrames << " frames: " << stats.issued
+                          << " issued, " << stats.skipped << " skipped" << std::endl;
+                polarclock::GLState::instance().resetStats();
+            }
+            statsFrames = 0;
+        }
 
         // Swap and poll
         platform->swapBuffers();
@@ -3,6 +3,7 @@
 #ifdef __ANDROID__
 
 #include <android_native_app_glue.h>
+#include <android/configuration.h>
 #include "../asset_loader.h"
 
 namespace polarclock {
@@ -207,6 +208,34 @@ void AndroidPlatform::getFramebufferSize(int& width, int& height) {
     height = m_height;
 }
 
+float AndroidPlatform::getContentScale() {
+    // Density is in dots per inch, relative to the 160 dpi Android baseline
+    int32_t density = m_app && m_app->config ? AConfiguration_getDensity(m_app->config) : 0;
+    if (density <= 0 || density == ACONFIGURATION_DENSITY_ANY || density == ACONFIGURATION_DENSITY_NONE) {
+        return 1.0f;
+    }
+    return static_cast<float>(density) / ACONFIGURATION_DENSITY_MEDIUM;
+}
+
+std::string AndroidPlatform::getCacheDirectory() {
+    if (!m_app || !m_app->activity || !m_app->activity->internalDataPath) {
+        return std::string();
+    }
+    return std::string(m_app->activity->internalDataPath) + "/cache";
+}
+
+void AndroidPlatform::setFrameDelay(double seconds) {
+    m_nextFrameTime = std::chrono::high_resolution_clock::now() +
+        std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+            std::chrono::duration<double>(seconds));
+}
+
+int AndroidPlatform::getPollTimeout() const {
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        m_nextFrameTime - std::chrono::high_resolution_clock::now());
+    return wait.count() > 0 ? static_cast<int>(wait.count()) : 0;
+}
+
 void AndroidPlatform::swapBuffers() {
     if (m_surface != EGL_NO_SURFACE && m_display != EGL_NO_DISPLAY) {
         eglSwapBuffers(m_display, m_surface);
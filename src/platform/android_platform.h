@@ -37,6 +37,9 @@ public:
     void shutdown() override;
     void runMainLoop(std::function<void(float deltaTime)> frameCallback) override;
     void getFramebufferSize(int& width, int& height) override;
+    float getContentScale() override;
+    std::string getCacheDirectory() override;
+    void setFrameDelay(double seconds) override;
     void swapBuffers() override;
     void pollEvents() override;
     bool shouldClose() override;
@@ -55,6 +58,10 @@ public:
     // State queries
     bool isPaused() const { return m_paused; }
     bool hasValidSurface() const { return m_surface != EGL_NO_SURFACE; }
+
+    // Milliseconds until the next frame is due (see setFrameDelay), for
+    // ALooper_pollAll
+    int getPollTimeout() const;
     bool isInitialized() const { return m_initialized; }
 
 private:
@@ -77,6 +84,7 @@ private:
     bool m_initialized = false;
 
     std::chrono::high_resolution_clock::time_point m_lastTime;
+    std::chrono::high_resolution_clock::time_point m_nextFrameTime;
 };
 
 } // namespace polarclock
@@ -3,6 +3,7 @@
 #if !defined(__EMSCRIPTEN__) && !defined(__ANDROID__)
 
 #include <iostream>
+#include <cstdlib>
 
 namespace polarclock {
 
@@ -102,6 +103,13 @@ void DesktopPlatform::runMainLoop(std::function<void(float deltaTime)> frameCall
         }
 
         frameCallback(deltaTime);
+
+        // Sleep until the next frame is due; any event wakes the loop early
+        double wait = std::chrono::duration<double>(
+            m_nextFrameTime - std::chrono::high_resolution_clock::now()).count();
+        if (wait > 0.0) {
+            glfwWaitEventsTimeout(wait);
+        }
     }
 }
 
@@ -109,6 +117,35 @@ void DesktopPlatform::getFramebufferSize(int& width, int& height) {
     glfwGetFramebufferSize(m_window, &width, &height);
 }
 
+float DesktopPlatform::getContentScale() {
+    float xscale = 1.0f, yscale = 1.0f;
+    glfwGetWindowContentScale(m_window, &xscale, &yscale);
+    return xscale;
+}
+
+std::string DesktopPlatform::getCacheDirectory() {
+#if defined(_WIN32)
+    const char* localAppData = std::getenv("LOCALAPPDATA");
+    return localAppData ? std::string(localAppData) + "\\PolarClock\\Cache" : std::string();
+#elif defined(__APPLE__)
+    const char* home = std::getenv("HOME");
+    return home ? std::string(home) + "/Library/Caches/PolarClock" : std::string();
+#else
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    if (cacheHome && cacheHome[0]) {
+        return std::string(cacheHome) + "/polarclock";
+    }
+    const char* home = std::getenv("HOME");
+    return home ? std::string(home) + "/.cache/polarclock" : std::string();
+#endif
+}
+
+void DesktopPlatform::setFrameDelay(double seconds) {
+    m_nextFrameTime = std::chrono::high_resolution_clock::now() +
+        std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+            std::chrono::duration<double>(seconds));
+}
+
 void DesktopPlatform::swapBuffers() {
     glfwSwapBuffers(m_window);
 }
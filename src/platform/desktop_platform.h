@@ -25,6 +25,9 @@ public:
     void shutdown() override;
     void runMainLoop(std::function<void(float deltaTime)> frameCallback) override;
     void getFramebufferSize(int& width, int& height) override;
+    float getContentScale() override;
+    std::string getCacheDirectory() override;
+    void setFrameDelay(double seconds) override;
     void swapBuffers() override;
     void pollEvents() override;
     bool shouldClose() override;
@@ -33,6 +36,7 @@ public:
 private:
     GLFWwindow* m_window = nullptr;
     std::chrono::high_resolution_clock::time_point m_lastTime;
+    std::chrono::high_resolution_clock::time_point m_nextFrameTime;
 };
 
 } // namespace polarclock
@@ -91,8 +91,9 @@ void EmscriptenPlatform::mainLoopCallback() {
 
 void EmscriptenPlatform::runMainLoop(std::function<void(float deltaTime)> frameCallback) {
     s_frameCallback = frameCallback;
-    // 60 FPS, infinite loop (1 = simulate infinite loop)
-    emscripten_set_main_loop(mainLoopCallback, 60, 1);
+    // Browser-paced (requestAnimationFrame) until setFrameDelay() asks for
+    // less, infinite loop (1 = simulate infinite loop)
+    emscripten_set_main_loop(mainLoopCallback, 0, 1);
 }
 
 void EmscriptenPlatform::getFramebufferSize(int& width, int& height) {
@@ -109,6 +110,28 @@ void EmscriptenPlatform::getFramebufferSize(int& width, int& height) {
     height = m_height;
 }
 
+float EmscriptenPlatform::getContentScale() {
+    return static_cast<float>(emscripten_get_device_pixel_ratio());
+}
+
+/**
+ * @brief Switch the main loop between animation frames and a timeout.
+ *
+ * Delays shorter than a 60 Hz frame stay on requestAnimationFrame, which
+ * paces the loop to the display anyway.
+ */
+void EmscriptenPlatform::setFrameDelay(double seconds) {
+    int timeoutMs = seconds > 1.0 / 60.0 ? static_cast<int>(seconds * 1000.0) : 0;
+    if (timeoutMs == m_timeoutMs) return;
+
+    m_timeoutMs = timeoutMs;
+    if (timeoutMs > 0) {
+        emscripten_set_main_loop_timing(EM_TIMING_SETTIMEOUT, timeoutMs);
+    } else {
+        emscripten_set_main_loop_timing(EM_TIMING_RAF, 1);
+    }
+}
+
 void EmscriptenPlatform::swapBuffers() {
     glfwSwapBuffers(m_window);
 }
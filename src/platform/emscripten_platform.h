@@ -27,6 +27,8 @@ public:
     void shutdown() override;
     void runMainLoop(std::function<void(float deltaTime)> frameCallback) override;
     void getFramebufferSize(int& width, int& height) override;
+    float getContentScale() override;
+    void setFrameDelay(double seconds) override;
     void swapBuffers() override;
     void pollEvents() override;
     bool shouldClose() override;
@@ -39,6 +41,7 @@ private:
     GLFWwindow* m_window = nullptr;
     std::chrono::high_resolution_clock::time_point m_lastTime;
     bool m_firstFrame = true;
+    int m_timeoutMs = 0;  // Main loop timeout, or 0 to run on requestAnimationFrame
     int m_width = 0;
     int m_height = 0;
 
@@ -49,6 +49,28 @@ public:
      */
     virtual void getFramebufferSize(int& width, int& height) = 0;
 
+    /**
+     * @brief Get the display's content scale (framebuffer pixels per logical pixel).
+     * @return 1.0 on standard-density displays and on platforms that cannot tell
+     */
+    virtual float getContentScale() { return 1.0f; }
+
+    /**
+     * @brief Get a writable per-user directory for caches that survive restarts.
+     * @return Directory path, or an empty string if there is none
+     */
+    virtual std::string getCacheDirectory() { return std::string(); }
+
+    /**
+     * @brief Let the main loop sleep before running the next frame.
+     *
+     * Input and window events still wake it early. With no delay (the
+     * default) frames run back to back, paced by vsync.
+     *
+     * @param seconds Time from now until the next frame is needed
+     */
+    virtual void setFrameDelay(double seconds) { (void)seconds; }
+
     /**
      * @brief Swap buffers after rendering.
      */
@@ -34,6 +34,7 @@ PolarClock::PolarClock()
         m_rings[i].outerRadius = m_rings[i].innerRadius + ringWidth;
         m_rings[i].currentValue = 0.0f;
         m_rings[i].targetValue = 0.0f;
+        m_rings[i].rate = 0.0f;
     }
 
     m_rings[0].type = RingType::Month;
@@ -72,7 +73,7 @@ void PolarClock::setTheme(const Theme& theme) {
     m_rings[4].colors = theme.month;
 }
 
-void PolarClock::setValue(RingType type, float value, int text_value)
+void PolarClock::setValue(RingType type, float value, float rate, int text_value)
 {
     auto pad2 = [](int n) {
         return (n < 10 ? "0" : "") + std::to_string(n);
@@ -83,6 +84,7 @@ void PolarClock::setValue(RingType type, float value, int text_value)
         if(ring.type == type)
         {
             ring.targetValue = value;
+            ring.rate = rate;
 
             switch(type)
             {
@@ -172,24 +174,34 @@ void PolarClock::updateRingValues() {
 
     // Seconds: 0-59, include fractional for smoothness
     float secondsValue = (m_seconds + m_fractionalSecond) / 60.0f;
-    setValue(RingType::Seconds, secondsValue, m_seconds);
+    setValue(RingType::Seconds, secondsValue, 1.0f / 60.0f, m_seconds);
 
     // Minutes: cascade from seconds
     float minutesValue = (m_minutes + secondsValue) / 60.0f;
-    setValue(RingType::Minutes, minutesValue, m_minutes);
+    setValue(RingType::Minutes, minutesValue, 1.0f / 3600.0f, m_minutes);
 
     // Hours: cascade from minutes (24-hour clock)
     float hoursValue = (m_hours + minutesValue) / 24.0f;
-    setValue(RingType::Hours, hoursValue, m_hours);
+    setValue(RingType::Hours, hoursValue, 1.0f / 86400.0f, m_hours);
 
     // Day of month: cascade from hours, use actual days in current month
     int daysInMonth = getDaysInMonth(m_month, m_year);
     float dayValue = ((m_dayOfMonth - 1) + hoursValue) / static_cast<float>(daysInMonth);
-    setValue(RingType::DayOfMonth, dayValue, m_dayOfMonth);
+    float dayRate = 1.0f / (86400.0f * daysInMonth);
+    setValue(RingType::DayOfMonth, dayValue, dayRate, m_dayOfMonth);
     
     // Month: cascade from days (1-12)
     float monthValue = ((m_month - 1) + dayValue) / 12.0f;
-    setValue(RingType::Month, monthValue, m_month);
+    setValue(RingType::Month, monthValue, dayRate / 12.0f, m_month);
+}
+
+bool PolarClock::isAnimating() const {
+    for (const auto& ring : m_rings) {
+        if (ring.currentValue != ring.targetValue) {
+            return true;
+        }
+    }
+    return false;
 }
 
 float PolarClock::animateValue(float current, float target, float deltaTime) {
@@ -19,6 +19,7 @@ struct Ring {
     RingType type;
     float currentValue;     // Current animated value (0.0 - 1.0)
     float targetValue;      // Target value to animate towards
+    float rate;             // Target value change per second as time passes
     float innerRadius;
     float outerRadius;
     std::string label;
@@ -28,13 +29,15 @@ struct Ring {
 
 class PolarClock {
 public:
+    static constexpr size_t RING_COUNT = 5;
+
     PolarClock();
 
     void update(float deltaTime);
     void setTheme(const Theme& theme);
 
     const Ring& getRing(RingType type) const { return m_rings[static_cast<size_t>(type)]; }
-    const std::array<Ring, 5>& getRings() const { return m_rings; }
+    const std::array<Ring, RING_COUNT>& getRings() const { return m_rings; }
     const Theme& getTheme() const { return m_theme; }
 
     // Get current time values for display
@@ -47,14 +50,21 @@ public:
 
     float getMaxRadius() const {return maximum_radius; }
 
+    // Fraction of the current second elapsed; labels change when it wraps
+    float getFractionalSecond() const { return m_fractionalSecond; }
+
+    // True while any ring is still catching up with its target (at startup
+    // and when a ring wraps around)
+    bool isAnimating() const;
+
 private:
     void updateTime();
     void updateRingValues();
     float animateValue(float current, float target, float deltaTime);
 
-    void setValue(RingType type, float value, int text_value);
+    void setValue(RingType type, float value, float rate, int text_value);
 
-    std::array<Ring, 5> m_rings;
+    std::array<Ring, RING_COUNT> m_rings;
     Theme m_theme;
 
     // Current time values
@@ -0,0 +1,227 @@
+#include "program_cache.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+namespace polarclock {
+
+namespace {
+
+constexpr char BINARY_MAGIC[4] = { 'P', 'C', 'P', 'B' };
+constexpr uint32_t BINARY_VERSION = 1;
+
+// FNV-1a, continuing from a previous hash
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t hashString(const std::string& text, uint64_t hash = 14695981039346656037ull) {
+    // Hash the terminator too, so ("ab", "c") and ("a", "bc") differ
+    return hashBytes(text.c_str(), text.size() + 1, hash);
+}
+
+std::string toHex(uint64_t value) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+    return buffer;
+}
+
+#ifndef __EMSCRIPTEN__
+std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+#endif
+
+} // namespace
+
+ProgramCache& ProgramCache::instance() {
+    static ProgramCache cache;
+    return cache;
+}
+
+ProgramCache::ProgramCache()
+    : m_supported(-1)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+void ProgramCache::setDirectory(const std::string& directory) {
+    m_directory = directory;
+    if (m_directory.empty()) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        std::cerr << "Program cache disabled, cannot create " << m_directory << ": "
+                  << error.message() << std::endl;
+        m_directory.clear();
+    }
+}
+
+/**
+ * @brief Check for a cache directory and driver support for program binaries.
+ *
+ * Support is queried once, on the first call with a current context.
+ */
+bool ProgramCache::isEnabled() {
+    if (m_directory.empty()) return false;
+
+    if (m_supported < 0) {
+#ifdef __EMSCRIPTEN__
+        m_supported = 0;
+#else
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+#if !defined(__ANDROID__)
+        // Desktop GL only has these entry points with GL 4.1 or ARB_get_program_binary
+        if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri) {
+            formats = 0;
+        }
+#endif
+        m_supported = formats > 0 ? 1 : 0;
+        if (m_supported) {
+            m_driverKey = toHex(hashString(glString(GL_VERSION),
+                                hashString(glString(GL_RENDERER),
+                                hashString(glString(GL_VENDOR)))));
+        }
+#endif
+    }
+    return m_supported > 0;
+}
+
+void ProgramCache::prepare(GLuint program) {
+#ifndef __EMSCRIPTEN__
+    if (isEnabled()) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#else
+    (void)program;
+#endif
+}
+
+std::string ProgramCache::pathFor(const std::string& vertSource, const std::string& fragSource) {
+    uint64_t sourceHash = hashString(fragSource, hashString(vertSource));
+    return m_directory + "/" + m_driverKey + "-" + toHex(sourceHash) + ".bin";
+}
+
+/**
+ * @brief Recreate a program from its cached binary.
+ *
+ * The file holds a small header (magic, version, binary format, length)
+ * followed by the blob. The driver may still refuse a blob it produced
+ * itself, so the program's link status decides whether it is used.
+ *
+ * @return A linked program, or 0 if there is no usable binary.
+ */
+GLuint ProgramCache::load(const std::string& vertSource, const std::string& fragSource) {
+    if (!isEnabled()) return 0;
+
+#ifndef __EMSCRIPTEN__
+    std::string path = pathFor(vertSource, fragSource);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        ++m_misses;
+        return 0;
+    }
+
+    char magic[4] = {};
+    uint32_t version = 0, format = 0, length = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    file.read(reinterpret_cast<char*>(&length), sizeof(length));
+
+    std::vector<char> binary;
+    if (file && std::equal(magic, magic + 4, BINARY_MAGIC) && version == BINARY_VERSION && length > 0) {
+        binary.resize(length);
+        file.read(binary.data(), length);
+    }
+    bool valid = file && !binary.empty();
+    file.close();
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, static_cast<GLenum>(format), binary.data(), static_cast<GLsizei>(length));
+
+        GLint success = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    if (!program) {
+        std::cerr << "Discarding stale program binary " << path << std::endl;
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        ++m_misses;
+        return 0;
+    }
+
+    ++m_hits;
+    return program;
+#else
+    return 0;
+#endif
+}
+
+void ProgramCache::store(GLuint program, const std::string& vertSource, const std::string& fragSource) {
+    if (!isEnabled()) return;
+
+#ifndef __EMSCRIPTEN__
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    // Write to a temporary name first so a crash never leaves a torn binary
+    std::string path = pathFor(vertSource, fragSource);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        uint32_t version = BINARY_VERSION;
+        uint32_t binaryFormat = format;
+        uint32_t binaryLength = static_cast<uint32_t>(written);
+        file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        file.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(binaryFormat));
+        file.write(reinterpret_cast<const char*>(&binaryLength), sizeof(binaryLength));
+        file.write(binary.data(), written);
+        if (!file) {
+            std::cerr << "Failed to write program binary " << tempPath << std::endl;
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Failed to write program binary " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+    }
+#else
+    (void)program;
+    (void)vertSource;
+    (void)fragSource;
+#endif
+}
+
+} // namespace polarclock
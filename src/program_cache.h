@@ -0,0 +1,56 @@
+#pragma once
+
+#include "shader.h"
+#include <string>
+
+namespace polarclock {
+
+/**
+ * @brief Linked program binaries kept on disk between launches.
+ *
+ * After a program links from source, its glGetProgramBinary blob is written
+ * to the cache directory under a name made of two hashes: one of the GL
+ * vendor, renderer and version strings, one of the shader sources. Later
+ * launches on the same driver hand the blob to glProgramBinary instead of
+ * compiling. A blob the driver rejects (e.g. after a driver update that kept
+ * its version string) is deleted and the program is built from source again.
+ *
+ * The cache is off until setDirectory() is given a directory, and always off
+ * where the context reports no binary formats, which includes WebGL.
+ */
+class ProgramCache {
+public:
+    static ProgramCache& instance();
+
+    // Directory to keep binaries in, created if needed; empty disables the cache
+    void setDirectory(const std::string& directory);
+    bool isEnabled();
+
+    // Ask the driver to keep a binary for a program about to be linked
+    void prepare(GLuint program);
+
+    // Create a linked program from the binary cached for these sources, or 0
+    GLuint load(const std::string& vertSource, const std::string& fragSource);
+
+    // Write a freshly linked program's binary for these sources
+    void store(GLuint program, const std::string& vertSource, const std::string& fragSource);
+
+    // Programs loaded from binaries and built from source since launch
+    int getHits() const { return m_hits; }
+    int getMisses() const { return m_misses; }
+
+private:
+    ProgramCache();
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    std::string pathFor(const std::string& vertSource, const std::string& fragSource);
+
+    std::string m_directory;
+    std::string m_driverKey;  // Hex hash of the driver strings, empty until first use
+    int m_supported;          // -1 until the context has been queried
+    int m_hits;
+    int m_misses;
+};
+
+} // namespace polarclock
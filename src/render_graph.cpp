@@ -0,0 +1,77 @@
+#include "render_graph.h"
+#include "gl_state.h"
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+namespace polarclock {
+
+void RenderGraph::submit(RenderPass pass, const DrawState& state, DrawBatcher& batcher, uint32_t item) {
+    m_packets.push_back({ pass, state, &batcher, item });
+}
+
+/**
+ * @brief Order packets by pass, then blend, program and texture.
+ *
+ * Blending sorts first so each pass toggles it at most once. The batcher
+ * comes last, so equal state from different subsystems still separates
+ * into one run per batcher.
+ */
+bool RenderGraph::sortsBefore(const DrawPacket& a, const DrawPacket& b) {
+    auto key = [](const DrawPacket& packet) {
+        return std::make_tuple(packet.pass, packet.state.blend, packet.state.program, packet.state.texture);
+    };
+    if (key(a) != key(b)) {
+        return key(a) < key(b);
+    }
+    return std::less<DrawBatcher*>()(a.batcher, b.batcher);
+}
+
+bool RenderGraph::canMerge(const DrawPacket& a, const DrawPacket& b) {
+    return a.pass == b.pass && a.batcher == b.batcher &&
+           a.state.blend == b.state.blend &&
+           a.state.program == b.state.program &&
+           a.state.texture == b.state.texture;
+}
+
+/**
+ * @brief Sort, merge and draw all submitted packets.
+ *
+ * Blending is set here for each batch; batchers bind their own programs,
+ * textures and vertex arrays through GLState, so consecutive batches that
+ * share any of them do not rebind it.
+ */
+void RenderGraph::execute() {
+    std::stable_sort(m_packets.begin(), m_packets.end(), sortsBefore);
+
+    m_lastPacketCount = m_packets.size();
+    m_lastBatchCount = 0;
+
+    for (size_t first = 0; first < m_packets.size();) {
+        const DrawPacket& packet = m_packets[first];
+
+        m_items.clear();
+        size_t end = first;
+        while (end < m_packets.size() && canMerge(packet, m_packets[end])) {
+            m_items.push_back(m_packets[end].item);
+            ++end;
+        }
+
+        GLState::instance().setEnabled(GL_BLEND, packet.state.blend);
+        packet.batcher->drawBatch(m_items.data(), m_items.size());
+        ++m_lastBatchCount;
+
+        if (std::find(m_batchers.begin(), m_batchers.end(), packet.batcher) == m_batchers.end()) {
+            m_batchers.push_back(packet.batcher);
+        }
+        first = end;
+    }
+
+    for (DrawBatcher* batcher : m_batchers) {
+        batcher->clearSubmitted();
+    }
+    m_batchers.clear();
+    m_packets.clear();
+}
+
+} // namespace polarclock
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "shader.h"
+#include <vector>
+#include <cstdint>
+
+namespace polarclock {
+
+// Stages of a frame, executed in order. Packets never move across passes,
+// so a later pass always draws on top of an earlier one.
+enum class RenderPass : uint8_t {
+    Main,     // Ring arcs
+    Overlay   // Labels on top of the arcs
+};
+
+// GL state a packet draws with; packets in a pass are sorted on it
+struct DrawState {
+    GLuint program = 0;
+    GLuint texture = 0;
+    bool blend = true;
+};
+
+/**
+ * @brief A subsystem that draws its own queued items.
+ *
+ * Items are whatever the subsystem queued when it submitted the packet
+ * (an arc, a label quad, a string); the graph only passes their indices
+ * back, merged into as few calls as the sort allows.
+ */
+class DrawBatcher {
+public:
+    virtual ~DrawBatcher() = default;
+
+    // Draw these items, given in submission order, with one batch's state
+    virtual void drawBatch(const uint32_t* items, size_t count) = 0;
+
+    // Forget everything queued; called once per frame after all batches
+    virtual void clearSubmitted() = 0;
+};
+
+/**
+ * @brief Per-frame command list of draw packets.
+ *
+ * Subsystems submit packets in whatever order suits them (e.g. ring by
+ * ring), and execute() sorts them by pass, blend state, program and
+ * texture, then merges runs with the same state and batcher into a single
+ * drawBatch() call. Sorting is stable, so packets that merge keep their
+ * submission order, and so do packets that cannot be reordered because
+ * they share all state.
+ */
+class RenderGraph {
+public:
+    void submit(RenderPass pass, const DrawState& state, DrawBatcher& batcher, uint32_t item);
+
+    // Draw and clear everything submitted since the last call
+    void execute();
+
+    // Packets and batches drawn by the last execute()
+    size_t getPacketCount() const { return m_lastPacketCount; }
+    size_t getBatchCount() const { return m_lastBatchCount; }
+
+private:
+    struct DrawPacket {
+        RenderPass pass;
+        DrawState state;
+        DrawBatcher* batcher;
+        uint32_t item;
+    };
+
+    static bool sortsBefore(const DrawPacket& a, const DrawPacket& b);
+    static bool canMerge(const DrawPacket& a, const DrawPacket& b);
+
+    std::vector<DrawPacket> m_packets;
+    std::vector<uint32_t> m_items;           // Items of the batch being drawn
+    std::vector<DrawBatcher*> m_batchers;    // Distinct batchers seen this frame
+    size_t m_lastPacketCount = 0;
+    size_t m_lastBatchCount = 0;
+};
+
+} // namespace polarclock
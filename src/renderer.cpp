@@ -1,33 +1,121 @@
 #include "renderer.h"
+#include "gl_state.h"
 #include <cmath>
+#include <iostream>
 
 namespace polarclock {
 
 Renderer::Renderer()
-    : m_width(800)
-    , m_height(800)
+    : m_labelCacheReady(false)
+    , m_width(0)
+    , m_height(0)
     , m_scale(1.0f)
 {
     m_theme = createDefaultTheme();
 }
 
 bool Renderer::init(int width, int height) {
-    m_width = width;
-    m_height = height;
+    // The context may be new (Android recreates it on resume), so nothing
+    // cached about the previous one still holds
+    GLState::instance().reset();
+
+    // Per-frame budget for streamed vertices: enough for every ring's arc at
+    // the finest tessellation, so a frame never overflows its region
+    GLsizeiptr streamBytes = PolarClock::RING_COUNT * ArcRenderer::getMaxStreamBytes() + TEXT_STREAM_BYTES;
+    if (!m_stream.init(streamBytes)) {
+        return false;
+    }
 
-    if (!m_arcRenderer.init()) {
+    if (!m_globals.init()) {
         return false;
     }
+    m_startTime = std::chrono::steady_clock::now();
 
-    if (!m_textRenderer.init("assets/RobotoMono-Bold.ttf", 72.0f)) {
+    if (!m_arcRenderer.init(m_stream)) {
         return false;
     }
 
+    if (!m_textRenderer.init("assets/RobotoMono-Bold.ttf", 72.0f, m_stream)) {
+        return false;
+    }
+    pollPrograms();
+
+    // Without the label cache, labels are drawn glyph by glyph every frame
+    m_labelCacheReady = m_labelCache.init(m_stream);
+    pollPrograms();
+
+    // Every program was submitted above and compiled while the font loaded;
+    // only now wait for the driver to finish those still pending
+    if (!m_arcRenderer.waitForPrograms() || !m_textRenderer.waitForPrograms()) {
+        return false;
+    }
+    m_labelCacheReady = m_labelCacheReady && m_labelCache.waitForPrograms();
+    if (!m_labelCacheReady) {
+        std::cerr << "Label cache unavailable, drawing labels directly" << std::endl;
+    }
+
     resize(width, height);
+    warmUpPrograms();
     return true;
 }
 
+/**
+ * @brief Collect the programs the driver has finished since the last asset-load step.
+ */
+void Renderer::pollPrograms() {
+    m_arcRenderer.pollPrograms();
+    m_textRenderer.pollPrograms();
+    if (m_labelCacheReady) {
+        m_labelCache.pollPrograms();
+    }
+}
+
+/**
+ * @brief Draw once with every program before the first visible frame.
+ *
+ * Many drivers only finish compiling a program, for the exact vertex
+ * formats and blend state in use, at its first draw. Doing that here with
+ * an empty scissor box moves the hitch out of the first frame without
+ * touching any pixels.
+ */
+void Renderer::warmUpPrograms() {
+    m_stream.beginFrame();
+    m_globals.bind();
+
+    GLState::instance().setEnabled(GL_BLEND, true);
+    GLState::instance().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::instance().setEnabled(GL_SCISSOR_TEST, true);
+    GLState::instance().scissor(0, 0, 0, 0);
+
+    const math::Vec3 color(1.0f, 1.0f, 1.0f);
+    ArcRenderMode mode = m_arcRenderer.getMode();
+    for (ArcRenderMode warmMode : { ArcRenderMode::Mesh, ArcRenderMode::Sdf, ArcRenderMode::Instanced }) {
+        m_arcRenderer.setMode(warmMode);
+        m_arcRenderer.renderArc(0.5, 0.6, 0.5, color);
+    }
+    m_arcRenderer.setMode(mode);
+
+    m_textRenderer.renderText("0", 0.0f, 0.0f, 0.001f, color);
+    m_textRenderer.renderTextOnArc("0", 0.5f, 0.0f, 0.001f, color);
+    m_textRenderer.flush();
+
+    if (m_labelCacheReady) {
+        m_labelCache.submit(m_graph, RenderPass::Overlay, 0, 0.0f, color, 1.0f);
+        m_graph.execute();
+    }
+    m_textRenderer.endFrame();
+
+    GLState::instance().setEnabled(GL_SCISSOR_TEST, false);
+
+    m_stream.endFrame();
+}
+
 void Renderer::resize(int width, int height) {
+    // The platform loops call this every frame; only act on a real change
+    if (width == m_width && height == m_height) {
+        return;
+    }
+
     m_width = width;
     m_height = height;
 
@@ -38,26 +126,58 @@ void Renderer::resize(int width, int height) {
     // Create orthographic projection centered at origin, with -1 to 1 range
     float aspect = static_cast<float>(width) / height;
     if (aspect >= 1.0f) {
-        m_projection = math::Mat4::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f);
+        m_globals.setProjection(math::Mat4::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f));
     } else {
-        m_projection = math::Mat4::ortho(-1.0f, 1.0f, -1.0f/aspect, 1.0f/aspect, -1.0f, 1.0f);
+        m_globals.setProjection(math::Mat4::ortho(-1.0f, 1.0f, -1.0f/aspect, 1.0f/aspect, -1.0f, 1.0f));
     }
+    m_globals.setViewport(width, height);
+    m_globals.setPixelScale(m_scale);
 
-    glViewport(0, 0, width, height);
+    GLState::instance().viewport(0, 0, width, height);
+
+    // One world unit spans m_scale pixels, which drives arc tessellation density
+    m_arcRenderer.setPixelScale(m_scale);
 }
 
 void Renderer::setTheme(const Theme& theme) {
     m_theme = theme;
 }
 
-float Renderer::calculateMinArcValue(const Ring& ring, float scale) {
+bool Renderer::setTextAtlasMode(FontAtlasMode mode) {
+    // Cached labels were rendered from the old atlas
+    m_labelCache.invalidate();
+    return m_textRenderer.setAtlasMode(mode);
+}
+
+/**
+ * @brief Measure a ring's label, reusing the previous result if the text is unchanged.
+ *
+ * Most labels change once a second or less, so this avoids re-measuring
+ * every label twice per frame.
+ */
+const Renderer::LabelMetrics& Renderer::updateLabelMetrics(size_t index, const std::string& text) {
+    if (m_labels.size() <= index) {
+        m_labels.resize(index + 1);
+    }
+
+    LabelMetrics& metrics = m_labels[index];
+    if (metrics.text != text) {
+        const TextLayout& layout = m_textRenderer.layout(text);
+        metrics.text = text;
+        metrics.width = layout.width;
+        metrics.height = layout.height;
+    }
+    return metrics;
+}
+
+float Renderer::calculateMinArcValue(const Ring& ring, const LabelMetrics& metrics, float scale) {
     // Calculate text properties
     float ringThickness = ring.outerRadius * scale - ring.innerRadius * scale;
     float textScale = ringThickness * 0.005f * scale;
-    float radius = ring.outerRadius * scale - m_textRenderer.getTextHeight(ring.valueText, textScale);
+    float radius = ring.outerRadius * scale - metrics.height * textScale;
 
     // Calculate how much angular space the text needs
-    float textWidth = m_textRenderer.getTextWidth(ring.valueText, textScale);
+    float textWidth = metrics.width * textScale;
     float textAngularSpan = textWidth / radius;
 
     // Add padding on both sides
@@ -69,21 +189,25 @@ float Renderer::calculateMinArcValue(const Ring& ring, float scale) {
 }
 
 void Renderer::render(const PolarClock& clock) {
-    // Clear with background color from clock's theme
-    const auto& bg = clock.getTheme().background;
-    glClearColor(bg.x, bg.y, bg.z, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    m_stream.beginFrame();
 
     // Create a scale factor to make everything nicely fit to the screen.
-    float ring_scale = .9 / clock.getMaxRadius();
-
-    // Enable blending for text
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Render arcs and labels with minimum arc sizes enforced
-    for (const auto& ring : clock.getRings()) {
-        float minValue = calculateMinArcValue(ring, ring_scale);
+    float ring_scale = getRingScale(clock);
+
+    // Blend the label text rendered offscreen below; the render graph sets
+    // blending for its own batches. It is left on between frames, so after
+    // the first frame this costs nothing.
+    GLState::instance().setEnabled(GL_BLEND, true);
+    GLState::instance().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Resolve arc sweeps (with minimum arc sizes enforced) and colors, and
+    // submit each ring's arc. The render graph draws them together later.
+    const auto& rings = clock.getRings();
+    m_placements.clear();
+    for (size_t i = 0; i < rings.size(); ++i) {
+        const Ring& ring = rings[i];
+        const LabelMetrics& metrics = updateLabelMetrics(i, ring.valueText);
+        float minValue = calculateMinArcValue(ring, metrics, ring_scale);
         float effectiveValue = std::max(ring.currentValue, minValue);
 
         // Interpolate color from bright (at 0) to base (at 1)
@@ -95,34 +219,90 @@ void Renderer::render(const PolarClock& clock) {
             ring.colors.bright.z + (ring.colors.base.z - ring.colors.bright.z) * t
         );
 
-        // Render arc with effective value and interpolated color
-        m_arcRenderer.renderArc(
+        m_arcRenderer.submit(m_graph, RenderPass::Main, {
             ring.innerRadius * ring_scale, ring.outerRadius * ring_scale,
             effectiveValue,
-            arcColor,
-            m_projection
-        );
+            arcColor
+        });
+        m_placements.push_back(placeLabel(ring, metrics, effectiveValue, ring_scale));
+    }
+
+    // Re-render labels whose text or layout changed into the label cache.
+    // This draws offscreen, so it happens before the frame is cleared.
+    for (size_t i = 0; i < rings.size(); ++i) {
+        LabelPlacement& placement = m_placements[i];
+        placement.cached = m_labelCacheReady &&
+            m_labelCache.update(i, m_textRenderer, rings[i].valueText,
+                                placement.radius, placement.textScale, m_scale);
+    }
+    GLState::instance().viewport(0, 0, m_width, m_height);
+
+    // Every program reads its projection from the shared block; only the
+    // time changes from frame to frame
+    m_globals.setTime(std::chrono::duration<float>(std::chrono::steady_clock::now() - m_startTime).count());
+    m_globals.bind();
+
+    // Clear with background color from clock's theme
+    const auto& bg = clock.getTheme().background;
+    glClearColor(bg.x, bg.y, bg.z, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-        // Render label
-        renderLabel(ring, effectiveValue, ring_scale);
+    // Labels go in the overlay pass, on top of every arc (rings never
+    // overlap, so this looks identical to interleaving them). Updating the
+    // label cache above decides whether each one is drawn from the cache.
+    for (size_t i = 0; i < rings.size(); ++i) {
+        renderLabel(i, rings[i], m_placements[i]);
     }
 
-    glDisable(GL_BLEND);
+    // One batch each for the arcs, the cached labels and any text that could
+    // not be cached, however many rings there are
+    m_graph.execute();
+    m_textRenderer.endFrame();
+
+    m_stream.endFrame();
 }
 
-void Renderer::renderLabel(const Ring& ring, float effectiveValue, float scale) {
+/**
+ * @brief Work out how long the current frame stays accurate.
+ *
+ * Each ring's arc end moves at its rate times the circumference of its
+ * outer edge in pixels; the next frame is due when the fastest one has
+ * moved VISIBLE_CHANGE_PIXELS, or when the labels change at the next whole
+ * second, whichever comes first. Arcs held at their minimum length for the
+ * label do not actually move, so this errs towards drawing too often.
+ */
+double Renderer::getTimeUntilChange(const PolarClock& clock) const {
+    if (clock.isAnimating()) {
+        return 0.0;
+    }
+
+    double delay = 1.0 - clock.getFractionalSecond();
+    float ringScale = getRingScale(clock);
+    for (const Ring& ring : clock.getRings()) {
+        double pixelsPerSecond = ring.rate * math::TAU * ring.outerRadius * ringScale * m_scale;
+        if (pixelsPerSecond > 0.0) {
+            delay = std::min(delay, VISIBLE_CHANGE_PIXELS / pixelsPerSecond);
+        }
+    }
+    return delay;
+}
+
+/**
+ * @brief Work out where a ring's label goes: near the end of its arc,
+ * inset from the outer edge by the label's height.
+ */
+Renderer::LabelPlacement Renderer::placeLabel(const Ring& ring, const LabelMetrics& metrics,
+                                              float effectiveValue, float scale) {
     // Calculate text properties
     float ringThickness = ring.outerRadius * scale - ring.innerRadius * scale;
     float textScale = ringThickness * 0.005f * scale;
 
-    std::string label = ring.valueText;
-
     // Position at center of ring thickness
     //float radius = (ring.innerRadius + ring.outerRadius) / 2.0f;
-    float radius = ring.outerRadius * scale - m_textRenderer.getTextHeight(label, textScale);
+    float radius = ring.outerRadius * scale - metrics.height * textScale;
 
     // Calculate how much angular space the text needs
-    float textWidth = m_textRenderer.getTextWidth(label, textScale);
+    float textWidth = metrics.width * textScale;
     float textAngularSpan = textWidth / radius;
 
     // Calculate arc angles using effective value
@@ -134,16 +314,25 @@ void Renderer::renderLabel(const Ring& ring, float effectiveValue, float scale)
     float padding = ringThickness * 0.1f / radius;
     float textCenterAngle = arcEndAngle + textAngularSpan / 2.0f + padding;
 
+    return { radius, textScale, textCenterAngle, false };
+}
+
+void Renderer::renderLabel(size_t index, const Ring& ring, const LabelPlacement& placement) {
     // Use dark color for contrast against bright arc
     math::Vec3 textColor(0.05f, 0.05f, 0.05f);
 
-    m_textRenderer.renderTextOnArc(
-        label,
-        radius,
-        textCenterAngle,
-        textScale,
+    if (placement.cached) {
+        m_labelCache.submit(m_graph, RenderPass::Overlay, index, placement.centerAngle, textColor, 1.0f);
+        return;
+    }
+
+    m_textRenderer.submitTextOnArc(
+        m_graph, RenderPass::Overlay,
+        ring.valueText,
+        placement.radius,
+        placement.centerAngle,
+        placement.textScale,
         textColor,
-        m_projection,
         true,  // clockwise (text follows arc direction)
         1.0f
     );
@@ -2,9 +2,16 @@
 
 #include "arc_renderer.h"
 #include "text_renderer.h"
+#include "label_cache.h"
+#include "frame_globals.h"
+#include "render_graph.h"
+#include "stream_buffer.h"
 #include "polar_clock.h"
 #include "theme.h"
 #include "pcmath.h"
+#include <vector>
+#include <string>
+#include <chrono>
 
 namespace polarclock {
 
@@ -17,19 +24,65 @@ public:
     void resize(int width, int height);
     void render(const PolarClock& clock);
     void setTheme(const Theme& theme);
+    void setArcMode(ArcRenderMode mode) { m_arcRenderer.setMode(mode); }
+    void setArcCompactVertices(bool compact) { m_arcRenderer.setCompactVertices(compact); }
+    bool setTextAtlasMode(FontAtlasMode mode);
+
+    // Framebuffer pixels per logical pixel (see Platform::getContentScale)
+    void setContentScale(float scale) { m_globals.setDpiScale(scale); }
+
+    // Seconds from now until rendering the clock again would change what is
+    // on screen; 0 while rings are animating
+    double getTimeUntilChange(const PolarClock& clock) const;
 
 private:
-    void renderLabel(const Ring& ring, float effectiveValue, float scale);
-    float calculateMinArcValue(const Ring& ring, float scale);
+    // Unscaled size of a ring's label, refreshed only when its text changes
+    struct LabelMetrics {
+        std::string text;
+        float width = 0.0f;
+        float height = 0.0f;
+    };
+
+    // Where a ring's label sits this frame
+    struct LabelPlacement {
+        float radius;       // Baseline radius
+        float textScale;
+        float centerAngle;
+        bool cached;        // Drawn from the label cache rather than glyph by glyph
+    };
+
+    const LabelMetrics& updateLabelMetrics(size_t index, const std::string& text);
+    LabelPlacement placeLabel(const Ring& ring, const LabelMetrics& metrics, float effectiveValue, float scale);
+    void renderLabel(size_t index, const Ring& ring, const LabelPlacement& placement);
+    void pollPrograms();
+    void warmUpPrograms();
+    float calculateMinArcValue(const Ring& ring, const LabelMetrics& metrics, float scale);
 
+    // World units per clock radius unit, fitting the outermost ring on screen
+    static float getRingScale(const PolarClock& clock) { return .9f / clock.getMaxRadius(); }
+
+    StreamBuffer m_stream;  // Declared first so it outlives the renderers using it
     ArcRenderer m_arcRenderer;
     TextRenderer m_textRenderer;
+    LabelCache m_labelCache;
+    bool m_labelCacheReady;
+    FrameGlobals m_globals;  // Projection, viewport, time and DPI for every program
+    RenderGraph m_graph;     // Arc and label draws, sorted and batched each frame
     Theme m_theme;
 
-    math::Mat4 m_projection;
+    std::vector<LabelMetrics> m_labels;  // One per ring
+    std::vector<LabelPlacement> m_placements;  // One per ring, reused each frame
+
+    std::chrono::steady_clock::time_point m_startTime;
     int m_width;
     int m_height;
     float m_scale;
+
+    // Arc edges must move this far before a frame is worth drawing
+    static constexpr float VISIBLE_CHANGE_PIXELS = 1.0f;
+
+    // Stream buffer space per frame for text and label quads, on top of the arcs
+    static constexpr GLsizeiptr TEXT_STREAM_BYTES = 64 * 1024;
 };
 
 } // namespace polarclock
@@ -1,9 +1,21 @@
 #include "shader.h"
+#include "gl_state.h"
 #include "asset_loader.h"
+#include "frame_globals.h"
+#include "program_cache.h"
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#include <emscripten/html5.h>
 #define SHADER_LOG(msg) emscripten_log(EM_LOG_CONSOLE, "Shader: %s", msg)
 #define SHADER_ERR(msg) emscripten_log(EM_LOG_ERROR, "Shader: %s", msg)
 #elif defined(__ANDROID__)
@@ -15,15 +27,113 @@
 #define SHADER_ERR(msg) std::cerr << "Shader: " << msg << std::endl
 #endif
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace polarclock {
 
+#ifndef NDEBUG
+/**
+ * @brief Replace an embedded source with the file of the same name in directory, if it exists.
+ */
+static void readShaderOverride(const char* directory, std::string_view name, std::string& source) {
+    std::string path = std::string(directory) + "/" + std::string(name);
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        SHADER_ERR(("No override for " + std::string(name) + " at " + path + ", using embedded source").c_str());
+        return;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    source = buffer.str();
+    SHADER_LOG(("Overriding " + std::string(name) + " from " + path).c_str());
+}
+#endif
+
+/**
+ * @brief Insert the shared FrameGlobals block (shaders/frame_globals.glsl) into a vertex shader.
+ *
+ * The block goes right after the #version line, which must come first, and
+ * a #line directive follows it so compile errors still report the line
+ * numbers of the original file.
+ */
+static std::string insertFrameGlobals(const std::string& vertSource) {
+    const EmbeddedShaderSource& entry = EMBEDDED_SHADERS[static_cast<size_t>(EmbeddedShader::FrameGlobalsGlsl)];
+    std::string prelude(entry.source);
+#ifndef NDEBUG
+    if (const char* directory = std::getenv("POLARCLOCK_SHADER_DIR")) {
+        readShaderOverride(directory, entry.name, prelude);
+    }
+#endif
+    if (!prelude.empty() && prelude.back() != '\n') {
+        prelude += '\n';
+    }
+
+    size_t position = 0;
+    if (vertSource.compare(0, 8, "#version") == 0) {
+        position = vertSource.find('\n');
+        position = position == std::string::npos ? vertSource.size() : position + 1;
+    }
+    int nextLine = position > 0 ? 2 : 1;
+
+    return vertSource.substr(0, position) + prelude +
+           "#line " + std::to_string(nextLine) + "\n" + vertSource.substr(position);
+}
+
+Shader::Shader()
+    : m_program(0)
+    , m_status(ShaderStatus::Empty)
+    , m_vertShader(0)
+    , m_fragShader(0)
+{
+}
+
 Shader::~Shader() {
+    releaseStages();
     if (m_program) {
-        glDeleteProgram(m_program);
+        GLState::instance().deleteProgram(m_program);
     }
 }
 
+bool Shader::loadEmbedded(EmbeddedShader vert, EmbeddedShader frag) {
+    return submitEmbedded(vert, frag) && wait();
+}
+
 bool Shader::loadFromFiles(const std::string& vertPath, const std::string& fragPath) {
+    return submitFromFiles(vertPath, fragPath) && wait();
+}
+
+bool Shader::loadFromSource(const std::string& vertSource, const std::string& fragSource) {
+    return submit(vertSource, fragSource) && wait();
+}
+
+/**
+ * @brief Start building a program from sources compiled into the binary.
+ *
+ * Debug builds read the same file names from the directory named by
+ * POLARCLOCK_SHADER_DIR instead, when it is set, so shaders can be edited
+ * without rebuilding.
+ */
+bool Shader::submitEmbedded(EmbeddedShader vert, EmbeddedShader frag) {
+    const EmbeddedShaderSource& vertEntry = EMBEDDED_SHADERS[static_cast<size_t>(vert)];
+    const EmbeddedShaderSource& fragEntry = EMBEDDED_SHADERS[static_cast<size_t>(frag)];
+
+    std::string vertSource(vertEntry.source);
+    std::string fragSource(fragEntry.source);
+#ifndef NDEBUG
+    if (const char* directory = std::getenv("POLARCLOCK_SHADER_DIR")) {
+        readShaderOverride(directory, vertEntry.name, vertSource);
+        readShaderOverride(directory, fragEntry.name, fragSource);
+    }
+#endif
+
+    m_name = std::string(vertEntry.name);
+    return submit(vertSource, fragSource);
+}
+
+bool Shader::submitFromFiles(const std::string& vertPath, const std::string& fragPath) {
     SHADER_LOG(("Loading: " + vertPath).c_str());
 
     std::string vertSource, fragSource;
@@ -38,89 +148,350 @@ bool Shader::loadFromFiles(const std::string& vertPath, const std::string& fragP
         return false;
     }
 
-    SHADER_LOG("Shader files loaded, compiling...");
-    return loadFromSource(vertSource, fragSource);
+    m_name = vertPath;
+    return submit(vertSource, fragSource);
 }
 
-bool Shader::loadFromSource(const std::string& vertSource, const std::string& fragSource) {
-    GLuint vertShader = compileShader(GL_VERTEX_SHADER, vertSource);
-    if (!vertShader) return false;
+/**
+ * @brief Start building the program without waiting for the driver.
+ *
+ * The FrameGlobals block is inserted into the vertex shader first, so it is
+ * part of the program cache key like the rest of the source.
+ *
+ * A cached binary makes the program ready at once. Otherwise both stages
+ * are compiled and the program is linked without reading any status back,
+ * since that is what blocks; with KHR_parallel_shader_compile the driver
+ * does the work on its own threads while the caller carries on. poll() or
+ * wait() then finishes the program.
+ *
+ * @return false if the GL objects could not be created.
+ */
+bool Shader::submit(const std::string& vertSource, const std::string& fragSource) {
+    m_submitTime = std::chrono::steady_clock::now();
+    std::string vert = insertFrameGlobals(vertSource);
+
+    // On WebGL this enables the extension, which must happen before compiling
+    hasParallelCompile();
 
-    GLuint fragShader = compileShader(GL_FRAGMENT_SHADER, fragSource);
-    if (!fragShader) {
-        glDeleteShader(vertShader);
+    ProgramCache& cache = ProgramCache::instance();
+    m_program = cache.load(vert, fragSource);
+    if (m_program) {
+        if (!onLinked()) {
+            glDeleteProgram(m_program);
+            m_program = 0;
+            m_status = ShaderStatus::Failed;
+            return false;
+        }
+        m_status = ShaderStatus::Ready;
+        logReady("loaded program binary");
+        return true;
+    }
+
+    m_vertShader = compileShader(GL_VERTEX_SHADER, vert);
+    m_fragShader = compileShader(GL_FRAGMENT_SHADER, fragSource);
+    if (!m_vertShader || !m_fragShader || !linkProgram()) {
+        SHADER_ERR("Failed to create program objects");
+        releaseStages();
+        m_status = ShaderStatus::Failed;
         return false;
     }
 
-    bool success = linkProgram(vertShader, fragShader);
+    // Kept until the link is done, as the key for the program cache
+    m_vertSource = vert;
+    m_fragSource = fragSource;
+    m_status = ShaderStatus::Pending;
+    return true;
+}
 
-    glDeleteShader(vertShader);
-    glDeleteShader(fragShader);
+/**
+ * @brief Check on a submitted program, finishing it if the driver is done.
+ *
+ * Only non-blocking where KHR_parallel_shader_compile is available;
+ * otherwise a pending program is finished here, which waits for the driver.
+ */
+ShaderStatus Shader::poll() {
+    if (m_status == ShaderStatus::Pending && hasParallelCompile()) {
+        GLint complete = GL_TRUE;
+        glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete) {
+            return ShaderStatus::Pending;
+        }
+    }
+    return m_status == ShaderStatus::Pending ? finishLink() : m_status;
+}
 
-    return success;
+bool Shader::wait() {
+    if (m_status == ShaderStatus::Pending) {
+        finishLink();
+    }
+    return m_status == ShaderStatus::Ready;
 }
 
 void Shader::use() const {
-    glUseProgram(m_program);
+    GLState::instance().useProgram(m_program);
 }
 
-void Shader::setMat4(const char* name, const float* data) const {
-    GLint loc = glGetUniformLocation(m_program, name);
-    glUniformMatrix4fv(loc, 1, GL_FALSE, data);
+UniformUploadStats Shader::s_uploadStats;
+int Shader::s_parallelCompile = -1;
+
+int Shader::uniform(const char* name) const {
+    for (size_t i = 0; i < m_uniforms.size(); ++i) {
+        if (m_uniforms[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
 }
 
-void Shader::setVec3(const char* name, float x, float y, float z) const {
-    GLint loc = glGetUniformLocation(m_program, name);
-    glUniform3f(loc, x, y, z);
+/**
+ * @brief Compare a value with the one last sent to a uniform and remember it.
+ *
+ * @return true if the value differs and has to be uploaded.
+ */
+bool Shader::needsUpload(int handle, const void* data, size_t size) {
+    if (handle < 0) return false;
+
+    std::vector<unsigned char>& last = m_uniforms[handle].value;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    if (last.size() == size && std::memcmp(last.data(), bytes, size) == 0) {
+        ++s_uploadStats.skipped;
+        return false;
+    }
+
+    last.assign(bytes, bytes + size);
+    ++s_uploadStats.issued;
+    return true;
 }
 
-void Shader::setFloat(const char* name, float value) const {
-    GLint loc = glGetUniformLocation(m_program, name);
-    glUniform1f(loc, value);
+/**
+ * @brief Check a handle against the type reflected at link time, for the setters' asserts.
+ *
+ * Samplers and bools are set through setInt(), so they pass as GL_INT.
+ */
+bool Shader::hasType(int handle, GLenum type) const {
+    if (handle < 0) return true;
+
+    GLenum actual = m_uniforms[handle].type;
+    if (type == GL_INT) {
+        return actual == GL_INT || actual == GL_BOOL ||
+               actual == GL_SAMPLER_2D || actual == GL_SAMPLER_2D_ARRAY ||
+               actual == GL_SAMPLER_3D || actual == GL_SAMPLER_CUBE;
+    }
+    return actual == type;
 }
 
-void Shader::setInt(const char* name, int value) const {
-    GLint loc = glGetUniformLocation(m_program, name);
-    glUniform1i(loc, value);
+void Shader::setMat4(int handle, const float* data) {
+    assert(hasType(handle, GL_FLOAT_MAT4));
+    if (needsUpload(handle, data, 16 * sizeof(float))) {
+        glUniformMatrix4fv(m_uniforms[handle].location, 1, GL_FALSE, data);
+    }
+}
+
+void Shader::setVec3(int handle, float x, float y, float z) {
+    assert(hasType(handle, GL_FLOAT_VEC3));
+    const float value[3] = { x, y, z };
+    if (needsUpload(handle, value, sizeof(value))) {
+        glUniform3f(m_uniforms[handle].location, x, y, z);
+    }
+}
+
+void Shader::setFloat(int handle, float value) {
+    assert(hasType(handle, GL_FLOAT));
+    if (needsUpload(handle, &value, sizeof(value))) {
+        glUniform1f(m_uniforms[handle].location, value);
+    }
+}
+
+void Shader::setInt(int handle, int value) {
+    assert(hasType(handle, GL_INT));
+    if (needsUpload(handle, &value, sizeof(value))) {
+        glUniform1i(m_uniforms[handle].location, value);
+    }
+}
+
+void Shader::setVec4Array(int handle, const float* data, int count) {
+    assert(hasType(handle, GL_FLOAT_VEC4));
+    assert(handle < 0 || count <= m_uniforms[handle].size);
+    if (needsUpload(handle, data, count * 4 * sizeof(float))) {
+        glUniform4fv(m_uniforms[handle].location, count, data);
+    }
+}
+
+void Shader::bindUniformBlock(const char* name, GLuint binding) const {
+    GLuint index = glGetUniformBlockIndex(m_program, name);
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(m_program, index, binding);
+    }
 }
 
 GLuint Shader::compileShader(GLenum type, const std::string& source) {
     GLuint shader = glCreateShader(type);
+    if (!shader) return 0;
+
     const char* src = source.c_str();
     glShaderSource(shader, 1, &src, nullptr);
     glCompileShader(shader);
-
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        std::cerr << "Shader compilation failed: " << infoLog << std::endl;
-        glDeleteShader(shader);
-        return 0;
-    }
-
     return shader;
 }
 
-bool Shader::linkProgram(GLuint vertShader, GLuint fragShader) {
+bool Shader::linkProgram() {
     m_program = glCreateProgram();
-    glAttachShader(m_program, vertShader);
-    glAttachShader(m_program, fragShader);
+    if (!m_program) return false;
+
+    glAttachShader(m_program, m_vertShader);
+    glAttachShader(m_program, m_fragShader);
+    ProgramCache::instance().prepare(m_program);
     glLinkProgram(m_program);
+    return true;
+}
 
-    GLint success;
+/**
+ * @brief Read back the link result of a submitted program.
+ *
+ * On failure the compile logs are reported in preference to the link log,
+ * since a stage that did not compile is the more useful error.
+ */
+ShaderStatus Shader::finishLink() {
+    GLint success = GL_FALSE;
     glGetProgramiv(m_program, GL_LINK_STATUS, &success);
-    if (!success) {
+
+    if (success && !onLinked()) {
+        glDeleteProgram(m_program);
+        m_program = 0;
+        m_status = ShaderStatus::Failed;
+    } else if (success) {
+        ProgramCache::instance().store(m_program, m_vertSource, m_fragSource);
+        m_status = ShaderStatus::Ready;
+        logReady("compiled and linked program");
+    } else {
         char infoLog[512];
-        glGetProgramInfoLog(m_program, 512, nullptr, infoLog);
-        std::cerr << "Program linking failed: " << infoLog << std::endl;
+        bool reported = false;
+        for (GLuint shader : { m_vertShader, m_fragShader }) {
+            GLint compiled = GL_FALSE;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+            if (!compiled) {
+                glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+                std::cerr << "Shader compilation failed: " << infoLog << std::endl;
+                reported = true;
+            }
+        }
+        if (!reported) {
+            glGetProgramInfoLog(m_program, sizeof(infoLog), nullptr, infoLog);
+            std::cerr << "Program linking failed: " << infoLog << std::endl;
+        }
         glDeleteProgram(m_program);
         m_program = 0;
+        m_status = ShaderStatus::Failed;
+    }
+
+    releaseStages();
+    return m_status;
+}
+
+void Shader::releaseStages() {
+    if (m_vertShader) glDeleteShader(m_vertShader);
+    if (m_fragShader) glDeleteShader(m_fragShader);
+    m_vertShader = 0;
+    m_fragShader = 0;
+    m_vertSource.clear();
+    m_fragSource.clear();
+}
+
+void Shader::logReady(const char* what) const {
+    char message[160];
+    std::snprintf(message, sizeof(message), "%s%s%s in %.2f ms",
+                  m_name.c_str(), m_name.empty() ? "" : ": ", what,
+                  std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_submitTime).count());
+    SHADER_LOG(message);
+}
+
+/**
+ * @brief Check once, with a context current, whether links can be polled.
+ *
+ * WebGL extensions have to be enabled before use; everywhere else the
+ * extension list is searched for the KHR or ARB variant (same token).
+ */
+bool Shader::hasParallelCompile() {
+    if (s_parallelCompile < 0) {
+#ifdef __EMSCRIPTEN__
+        s_parallelCompile = emscripten_webgl_enable_extension(emscripten_webgl_get_current_context(),
+                                                              "KHR_parallel_shader_compile") ? 1 : 0;
+#else
+        s_parallelCompile = 0;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 ||
+                         std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0)) {
+                s_parallelCompile = 1;
+                break;
+            }
+        }
+#endif
+        SHADER_LOG((s_parallelCompile ? "Parallel shader compile available" : "Parallel shader compile unavailable"));
+    }
+    return s_parallelCompile > 0;
+}
+
+/**
+ * @brief Set up a program that just linked, from source or from a binary.
+ *
+ * @return false if the program's FrameGlobals block is larger than the
+ *         buffer FrameGlobals uploads, so reads would run past its end.
+ */
+bool Shader::onLinked() {
+    reflectUniforms();
+
+    // Every program reads per-frame globals from the same buffer binding
+    GLuint index = glGetUniformBlockIndex(m_program, "FrameGlobals");
+    if (index == GL_INVALID_INDEX) {
+        return true;
+    }
+
+    GLint size = 0;
+    glGetActiveUniformBlockiv(m_program, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    if (static_cast<size_t>(size) > FrameGlobals::getBlockSize()) {
+        std::cerr << m_name << ": FrameGlobals block is " << size << " bytes, buffer is only "
+                  << FrameGlobals::getBlockSize() << std::endl;
         return false;
     }
 
+    glUniformBlockBinding(m_program, index, FRAME_GLOBALS_BINDING);
     return true;
 }
 
+/**
+ * @brief List the program's active default-block uniforms and their locations.
+ *
+ * Runs once after linking so setters never ask the driver for a location.
+ * Members of uniform blocks have no location and are skipped. Array names
+ * are stored without their "[0]" suffix.
+ */
+void Shader::reflectUniforms() {
+    m_uniforms.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> name(std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_program, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()),
+                           &length, &size, &type, name.data());
+
+        GLint location = glGetUniformLocation(m_program, name.data());
+        if (location < 0) continue;
+
+        std::string uniformName(name.data(), length);
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            uniformName.resize(uniformName.size() - 3);
+        }
+        m_uniforms.push_back({ uniformName, location, type, size, {} });
+    }
+}
+
 } // namespace polarclock
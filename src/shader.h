@@ -6,32 +6,113 @@
 #include <GL/glew.h>
 #endif
 
+#include "embedded_shaders.h"
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
 
 namespace polarclock {
 
+// An active uniform found by reflection at link time
+struct ShaderUniform {
+    std::string name;                  // Without any "[0]" array suffix
+    GLint location;
+    GLenum type;                       // GL_FLOAT_MAT4, GL_SAMPLER_2D, ...
+    GLint size;                        // Array length, 1 for non-arrays
+    std::vector<unsigned char> value;  // Last value uploaded, empty until the first upload
+};
+
+// glUniform* calls made and skipped as redundant, across all shaders
+struct UniformUploadStats {
+    uint64_t issued = 0;
+    uint64_t skipped = 0;
+};
+
+// Build progress of a Shader's program
+enum class ShaderStatus {
+    Empty,    // Nothing submitted
+    Pending,  // Submitted, link result not read back yet
+    Ready,
+    Failed
+};
+
 class Shader {
 public:
-    Shader() : m_program(0) {}
+    Shader();
     ~Shader();
 
+    // Build the program and wait for the result
+    bool loadEmbedded(EmbeddedShader vert, EmbeddedShader frag);
     bool loadFromFiles(const std::string& vertPath, const std::string& fragPath);
     bool loadFromSource(const std::string& vertSource, const std::string& fragSource);
 
+    // Start building the program and return without waiting for the driver,
+    // so several programs compile in parallel. Finish with poll() or wait()
+    // before using the program.
+    bool submitEmbedded(EmbeddedShader vert, EmbeddedShader frag);
+    bool submitFromFiles(const std::string& vertPath, const std::string& fragPath);
+    bool submit(const std::string& vertSource, const std::string& fragSource);
+
+    // Non-blocking with KHR_parallel_shader_compile; otherwise finishes the link
+    ShaderStatus poll();
+
+    // Finish the link if still pending; true if the program is ready
+    bool wait();
+
+    ShaderStatus getStatus() const { return m_status; }
+
     void use() const;
     GLuint getProgram() const { return m_program; }
 
-    // Uniform setters
-    void setMat4(const char* name, const float* data) const;
-    void setVec3(const char* name, float x, float y, float z) const;
-    void setFloat(const char* name, float value) const;
-    void setInt(const char* name, int value) const;
+    // Handle of an active uniform for the handle setters, or -1 if the
+    // program has no such uniform (setting -1 is a no-op)
+    int uniform(const char* name) const;
+    const std::vector<ShaderUniform>& getUniforms() const { return m_uniforms; }
+
+    // Uniform setters, taking a handle from uniform(). Values equal to the
+    // last one sent to this program are not uploaded again. The program must
+    // be in use.
+    void setMat4(int handle, const float* data);
+    void setVec3(int handle, float x, float y, float z);
+    void setFloat(int handle, float value);
+    void setInt(int handle, int value);
+    void setVec4Array(int handle, const float* data, int count);
+
+    static const UniformUploadStats& getUploadStats() { return s_uploadStats; }
+    static void resetUploadStats() { s_uploadStats = UniformUploadStats(); }
+
+    // Attach a uniform block to a buffer binding point (no-op if absent)
+    void bindUniformBlock(const char* name, GLuint binding) const;
+
+    // True if link completion can be queried (KHR_parallel_shader_compile)
+    static bool hasParallelCompile();
 
 private:
     GLuint m_program;
+    ShaderStatus m_status;
+    std::vector<ShaderUniform> m_uniforms;
+
+    // In flight between submit() and the end of the link
+    GLuint m_vertShader;
+    GLuint m_fragShader;
+    std::string m_vertSource;
+    std::string m_fragSource;
+    std::string m_name;  // Vertex shader name, for logs
+    std::chrono::steady_clock::time_point m_submitTime;
 
     GLuint compileShader(GLenum type, const std::string& source);
-    bool linkProgram(GLuint vertShader, GLuint fragShader);
+    bool linkProgram();
+    ShaderStatus finishLink();
+    void releaseStages();
+    void logReady(const char* what) const;
+    bool onLinked();
+    void reflectUniforms();
+    bool needsUpload(int handle, const void* data, size_t size);
+    bool hasType(int handle, GLenum type) const;
+
+    static UniformUploadStats s_uploadStats;
+    static int s_parallelCompile;  // -1 until queried
 };
 
 } // namespace polarclock
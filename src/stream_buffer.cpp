@@ -0,0 +1,147 @@
+#include "stream_buffer.h"
+#include "gl_state.h"
+#include <cstring>
+#include <iostream>
+
+namespace polarclock {
+
+StreamBuffer::StreamBuffer()
+    : m_buffer(0)
+    , m_regionSize(0)
+    , m_region(0)
+    , m_cursor(0)
+    , m_fences{}
+#ifdef __EMSCRIPTEN__
+    , m_useMapping(false)
+#else
+    , m_useMapping(true)
+#endif
+{
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync& fence : m_fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (m_buffer) GLState::instance().deleteBuffer(m_buffer);
+}
+
+bool StreamBuffer::init(GLsizeiptr regionSize) {
+    m_regionSize = regionSize;
+
+    glGenBuffers(1, &m_buffer);
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+    // Without mapping only one region is ever in use; orphaning handles the rest
+    GLsizeiptr capacity = m_useMapping ? m_regionSize * REGIONS : m_regionSize;
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+
+    return m_buffer != 0;
+}
+
+/**
+ * @brief Start writing to the next region.
+ *
+ * With mapping, the region's fence from REGIONS frames ago is waited on (it
+ * has normally long since signalled) so unsynchronized writes cannot race the
+ * GPU. If the wait times out or fails, the GPU may still be reading the
+ * region, so the buffer is orphaned rather than written under it. Without
+ * mapping, the buffer is orphaned so the driver hands back fresh
+ * storage instead of stalling on in-flight draws.
+ */
+void StreamBuffer::beginFrame() {
+    if (!m_useMapping) {
+        orphan();
+        m_cursor = 0;
+        return;
+    }
+
+    m_region = (m_region + 1) % REGIONS;
+    m_cursor = m_region * m_regionSize;
+
+    GLsync& fence = m_fences[m_region];
+    if (fence) {
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);  // 1 second
+        glDeleteSync(fence);
+        fence = nullptr;
+        if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+            std::cerr << "StreamBuffer: fence wait " << (result == GL_WAIT_FAILED ? "failed" : "timed out")
+                      << ", orphaning" << std::endl;
+            orphan();
+        }
+    }
+}
+
+void StreamBuffer::endFrame() {
+    if (!m_useMapping) return;
+
+    GLsync& fence = m_fences[m_region];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/**
+ * @brief Copy data into the current region.
+ *
+ * If the region is full the whole buffer is orphaned and writing restarts at
+ * the beginning of the region; the old storage stays alive for any draws
+ * still referencing it, so this is safe, merely slower. Data that does not
+ * fit between the first aligned offset in the region and the region's end
+ * (up to alignment - 1 bytes less than the region size, since regions need
+ * not start on a multiple of the alignment) cannot be placed at all; the
+ * caller must skip its draw.
+ */
+GLintptr StreamBuffer::upload(const void* data, GLsizeiptr size, GLsizeiptr alignment) {
+    GLintptr offset = ((m_cursor + alignment - 1) / alignment) * alignment;
+    GLintptr regionStart = m_useMapping ? m_region * m_regionSize : 0;
+    GLintptr regionEnd = regionStart + m_regionSize;
+
+    if (offset + size > regionEnd) {
+        GLintptr restart = ((regionStart + alignment - 1) / alignment) * alignment;
+        if (restart + size > regionEnd) {
+            std::cerr << "StreamBuffer: upload of " << size << " bytes does not fit in a region" << std::endl;
+            return UPLOAD_FAILED;
+        }
+        orphan();
+        offset = restart;
+    }
+
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+    if (m_useMapping) {
+        void* dst = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                                     GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                     GL_MAP_INVALIDATE_RANGE_BIT);
+        if (dst) {
+            std::memcpy(dst, data, static_cast<size_t>(size));
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            // Mapping failed on this driver; stop trying and use the fallback
+            m_useMapping = false;
+            glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+        }
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+
+    m_cursor = offset + size;
+    return offset;
+}
+
+/**
+ * @brief Replace the buffer's storage, dropping all outstanding fences.
+ */
+void StreamBuffer::orphan() {
+    for (GLsync& fence : m_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    GLsizeiptr capacity = m_useMapping ? m_regionSize * REGIONS : m_regionSize;
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+}
+
+} // namespace polarclock
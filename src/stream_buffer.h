@@ -0,0 +1,72 @@
+#pragma once
+
+#include "shader.h"
+
+namespace polarclock {
+
+/**
+ * @brief Shared streaming vertex buffer for per-frame dynamic geometry.
+ *
+ * One large VBO is split into REGIONS regions that are used round-robin, one
+ * per frame. Writes go through glMapBufferRange with GL_MAP_UNSYNCHRONIZED_BIT
+ * and each region is fenced with glFenceSync at the end of its frame, so the
+ * CPU only waits if the GPU is still REGIONS frames behind.
+ *
+ * On WebGL, where buffer mapping is emulated and slow, the buffer is instead
+ * orphaned once per frame and written with glBufferSubData.
+ *
+ * Callers suballocate with upload() and draw from the returned offset, or
+ * skip the draw if it is UPLOAD_FAILED. Passing
+ * the vertex stride as alignment lets the offset be turned into the `first`
+ * argument of glDrawArrays, so VAOs can point at offset 0 once at init.
+ */
+class StreamBuffer {
+public:
+    StreamBuffer();
+    ~StreamBuffer();
+
+    /**
+     * @brief Create the buffer.
+     * @param regionSize Bytes available to a single frame
+     * @return true if initialization succeeded
+     */
+    bool init(GLsizeiptr regionSize);
+
+    /**
+     * @brief Start writing to the next region, waiting on its fence if needed.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Fence the current region once all of this frame's draws are issued.
+     */
+    void endFrame();
+
+    /**
+     * @brief Copy data into the current region.
+     * @param data      Source data
+     * @param size      Size in bytes
+     * @param alignment Required alignment of the returned offset (e.g. vertex stride)
+     * @return Byte offset of the data within the buffer, or UPLOAD_FAILED if
+     *         it does not fit in a region once aligned
+     */
+    GLintptr upload(const void* data, GLsizeiptr size, GLsizeiptr alignment);
+
+    static constexpr GLintptr UPLOAD_FAILED = -1;
+
+    GLuint getBuffer() const { return m_buffer; }
+
+private:
+    void orphan();
+
+    static constexpr int REGIONS = 3;
+
+    GLuint m_buffer;
+    GLsizeiptr m_regionSize;
+    int m_region;
+    GLsizeiptr m_cursor;  // Absolute write offset within the buffer
+    GLsync m_fences[REGIONS];
+    bool m_useMapping;
+};
+
+} // namespace polarclock
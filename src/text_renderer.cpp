@@ -1,313 +1,581 @@
 #include "text_renderer.h"
+#include "gl_state.h"
 #include "asset_loader.h"
 #include <vector>
 #include <iostream>
 #include <cstring>
-
-#define STB_TRUETYPE_IMPLEMENTATION
-#include "stb_truetype.h"
+#include <cstddef>
+#include <algorithm>
 
 namespace polarclock {
 
 TextRenderer::TextRenderer()
-    : m_vao(0)
-    , m_vbo(0)
-    , m_fontTexture(0)
+    : m_stream(nullptr)
+    , m_sdfUniform(-1)
+    , m_vao(0)
+    , m_arcSdfUniform(-1)
+    , m_stringsUniform(-1)
+    , m_arcVao(0)
+    , m_cornerVbo(0)
+    , m_glyphTableUbo(0)
+    , m_atlasMode(FontAtlasMode::Bitmap)
     , m_fontSize(32.0f)
-    , m_atlasWidth(512)
-    , m_atlasHeight(512)
 {
 }
 
 TextRenderer::~TextRenderer() {
-    if (m_vao) glDeleteVertexArrays(1, &m_vao);
-    if (m_vbo) glDeleteBuffers(1, &m_vbo);
-    if (m_fontTexture) glDeleteTextures(1, &m_fontTexture);
+    if (m_vao) GLState::instance().deleteVertexArray(m_vao);
+    if (m_arcVao) GLState::instance().deleteVertexArray(m_arcVao);
+    if (m_cornerVbo) GLState::instance().deleteBuffer(m_cornerVbo);
+    if (m_glyphTableUbo) GLState::instance().deleteBuffer(m_glyphTableUbo);
 }
 
-bool TextRenderer::init(const std::string& fontPath, float fontSize) {
+bool TextRenderer::init(const std::string& fontPath, float fontSize, StreamBuffer& stream) {
     m_fontSize = fontSize;
+    m_stream = &stream;
 
-    // Load font file via AssetLoader
-    std::vector<unsigned char> fontBuffer;
-    if (!AssetLoader::instance().loadFile(fontPath, fontBuffer)) {
-        std::cerr << "Failed to load font file: " << fontPath << std::endl;
+    m_fontPath = fontPath;
+
+    // Submit the programs first so they compile while the font loads
+    if (!m_shader.submitEmbedded(EmbeddedShader::TextVert, EmbeddedShader::TextFrag) ||
+        !m_arcShader.submitEmbedded(EmbeddedShader::TextArcVert, EmbeddedShader::TextFrag)) {
         return false;
     }
 
-    // Initialize stb_truetype
-    stbtt_fontinfo fontInfo;
-    if (!stbtt_InitFont(&fontInfo, fontBuffer.data(), 0)) {
-        std::cerr << "Failed to initialize font" << std::endl;
+    if (!loadAtlas()) {
         return false;
     }
 
-    // Create font atlas
-    std::vector<unsigned char> atlasData(m_atlasWidth * m_atlasHeight, 0);
-    float scale = stbtt_ScaleForPixelHeight(&fontInfo, fontSize);
+    // Create VAO over the shared stream buffer
+    glGenVertexArrays(1, &m_vao);
 
-    int x = 2, y = 2;
-    int maxRowHeight = 0;
+    GLState::instance().bindVertexArray(m_vao);
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_stream->getBuffer());
 
-    // Bake ASCII characters 32-126
-    for (char c = 32; c < 127; ++c) {
-        int width, height, xoff, yoff;
-        unsigned char* bitmap = stbtt_GetCodepointBitmap(
-            &fontInfo, 0, scale, c, &width, &height, &xoff, &yoff);
+    // Position (vec2) + TexCoord and page (vec3) + Color (normalized RGBA8)
+    const GLsizei stride = sizeof(TextVertex);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TextVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TextVertex, u));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(TextVertex, color));
+    glEnableVertexAttribArray(2);
 
-        if (x + width + 2 >= m_atlasWidth) {
-            x = 2;
-            y += maxRowHeight + 2;
-            maxRowHeight = 0;
-        }
+    GLState::instance().bindVertexArray(0);
 
-        if (y + height + 2 >= m_atlasHeight) {
-            std::cerr << "Font atlas too small!" << std::endl;
-            stbtt_FreeBitmap(bitmap, nullptr);
-            break;
-        }
+    return initArcText();
+}
 
-        // Copy glyph to atlas
-        for (int row = 0; row < height; ++row) {
-            std::memcpy(&atlasData[(y + row) * m_atlasWidth + x],
-                       &bitmap[row * width], width);
-        }
+/**
+ * @brief Set up the glyph cache for the current mode.
+ *
+ * The atlas baked at build time by polarclock-fontbake, if present, is
+ * uploaded as-is and covers ASCII without any rasterization. Unless the
+ * runtime was built without stb_truetype (POLARCLOCK_NO_FONT_RASTER), the
+ * TTF is also loaded so the cache can rasterize anything else on first use;
+ * with no baked atlas that includes ASCII, so startup only pays for the
+ * glyphs actually shown.
+ *
+ * @return true if glyphs can be drawn, false otherwise.
+ */
+bool TextRenderer::loadAtlas() {
+    FontAtlas atlas;
+    std::string bakedPath = bakedFontAtlasPath(m_fontPath, m_fontSize, m_atlasMode);
+    std::vector<unsigned char> blob;
+    bool baked = AssetLoader::instance().loadFile(bakedPath, blob) &&
+                 readFontAtlas(blob, atlas) &&
+                 atlas.mode == m_atlasMode && atlas.fontSize == m_fontSize;
+
+#ifdef POLARCLOCK_NO_FONT_RASTER
+    if (!baked) {
+        std::cerr << "Missing or invalid baked font atlas: " << bakedPath << std::endl;
+        return false;
+    }
+    const std::vector<unsigned char>* fontData = nullptr;
+#else
+    if (!baked) {
+        std::cout << "No baked font atlas at " << bakedPath << ", rasterizing glyphs from " << m_fontPath << std::endl;
+    }
 
-        // Store glyph info
-        GlyphInfo glyph;
-        glyph.x0 = static_cast<float>(x) / m_atlasWidth;
-        glyph.y0 = static_cast<float>(y) / m_atlasHeight;
-        glyph.x1 = static_cast<float>(x + width) / m_atlasWidth;
-        glyph.y1 = static_cast<float>(y + height) / m_atlasHeight;
-        glyph.xoff = static_cast<float>(xoff);
-        glyph.yoff = static_cast<float>(yoff);
-        glyph.width = static_cast<float>(width);
-        glyph.height = static_cast<float>(height);
+    // Load font file via AssetLoader
+    if (m_fontData.empty() && !AssetLoader::instance().loadFile(m_fontPath, m_fontData)) {
+        std::cerr << "Failed to load font file: " << m_fontPath << std::endl;
+        if (!baked) return false;
+    }
+    const std::vector<unsigned char>* fontData = m_fontData.empty() ? nullptr : &m_fontData;
+#endif
 
-        int advanceWidth, leftSideBearing;
-        stbtt_GetCodepointHMetrics(&fontInfo, c, &advanceWidth, &leftSideBearing);
-        glyph.xadvance = advanceWidth * scale;
+    m_layouts.clear();
+    return m_glyphCache.init(m_atlasMode, m_fontSize, baked ? &atlas : nullptr, fontData);
+}
 
-        m_glyphs[c] = glyph;
+bool TextRenderer::setAtlasMode(FontAtlasMode mode) {
+    if (mode == m_atlasMode) return true;
 
-        x += width + 2;
-        maxRowHeight = std::max(maxRowHeight, height);
+    m_atlasMode = mode;
+    return loadAtlas();
+}
 
-        stbtt_FreeBitmap(bitmap, nullptr);
-    }
+/**
+ * @brief Initialize OpenGL resources for curved text.
+ *
+ * Creates the glyph metrics table (see uploadGlyphTable). Each glyph is
+ * drawn as an instance of a static unit quad; per-glyph instance data is
+ * streamed at flush time, so its pointer is set at draw time.
+ *
+ * @return true if initialization succeeded, false otherwise.
+ */
+bool TextRenderer::initArcText() {
+    glGenBuffers(1, &m_glyphTableUbo);
+
+    // Unit quad as a triangle strip, scaled to each glyph's box in the shader
+    const float corners[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 1.0f
+    };
+
+    glGenVertexArrays(1, &m_arcVao);
+    glGenBuffers(1, &m_cornerVbo);
+
+    GLState::instance().bindVertexArray(m_arcVao);
+
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_cornerVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
 
-    // Create OpenGL texture
-    glGenTextures(1, &m_fontTexture);
-    glBindTexture(GL_TEXTURE_2D, m_fontTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_atlasWidth, m_atlasHeight,
-                 0, GL_RED, GL_UNSIGNED_BYTE, atlasData.data());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    // Load shader
-    if (!m_shader.loadFromFiles("shaders/text.vert", "shaders/text.frag")) {
+    GLState::instance().bindVertexArray(0);
+
+    return true;
+}
+
+/**
+ * @brief Finish the text programs if they compiled while the font loaded.
+ */
+void TextRenderer::pollPrograms() {
+    m_shader.poll();
+    m_arcShader.poll();
+}
+
+/**
+ * @brief Finish the programs submitted by init(), set their constant
+ * uniforms and look up the ones set at draw time.
+ *
+ * @return true if both text programs linked, false otherwise.
+ */
+bool TextRenderer::waitForPrograms() {
+    if (!m_shader.wait() || !m_arcShader.wait()) {
         return false;
     }
 
-    // Create VAO/VBO
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
+    m_shader.use();
+    m_shader.setInt(m_shader.uniform("u_fontTexture"), 0);
+    m_sdfUniform = m_shader.uniform("u_sdf");
+
+    m_arcShader.use();
+    m_arcShader.bindUniformBlock("GlyphTable", GLYPH_TABLE_BINDING);
+    m_arcShader.setInt(m_arcShader.uniform("u_fontTexture"), 0);
+    m_arcShader.setFloat(m_arcShader.uniform("u_baseline"), -m_fontSize / 4.0f);
+    m_arcSdfUniform = m_arcShader.uniform("u_sdf");
+    m_stringsUniform = m_arcShader.uniform("u_strings");
+    return true;
+}
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+/**
+ * @brief Upload glyph metrics for text_arc.vert.
+ *
+ * The uniform buffer is laid out as the std140 GlyphTable block, indexed by
+ * glyph cache slot: atlas rects, then boxes, then advances and atlas pages
+ * packed four to a vec4. A box's x is the quad's left edge relative to the
+ * glyph's horizontal center, so the shader can center glyphs on the arc
+ * without knowing about SDF padding. Called whenever the cache's slots change.
+ */
+void TextRenderer::uploadGlyphTable() {
+    std::vector<float> table((GLYPH_TABLE_SIZE * 2 + GLYPH_TABLE_SIZE / 2) * 4, 0.0f);
+    float* uvs = table.data();
+    float* boxes = uvs + GLYPH_TABLE_SIZE * 4;
+    float* advances = boxes + GLYPH_TABLE_SIZE * 4;
+    float* pages = advances + GLYPH_TABLE_SIZE;
+    for (int index = 0; index < GLYPH_TABLE_SIZE; ++index) {
+        const CachedGlyph& glyph = m_glyphCache.slot(index);
+        if (glyph.page < 0) continue;
+
+        const GlyphInfo& g = glyph.info;
+        float* uv = uvs + index * 4;
+        uv[0] = g.x0; uv[1] = g.y0; uv[2] = g.x1; uv[3] = g.y1;
+        float* box = boxes + index * 4;
+        box[0] = g.xoff - g.inkWidth / 2.0f; box[1] = g.yoff; box[2] = g.width; box[3] = g.height;
+        advances[index] = g.xadvance;
+        pages[index] = static_cast<float>(glyph.page);
+    }
 
-    // Position (vec2) + TexCoord (vec2)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    GLState::instance().bindBuffer(GL_UNIFORM_BUFFER, m_glyphTableUbo);
+    glBufferData(GL_UNIFORM_BUFFER, table.size() * sizeof(float), table.data(), GL_DYNAMIC_DRAW);
+}
 
-    glBindVertexArray(0);
+/**
+ * @brief Pack a color and alpha into RGBA8 for the batched vertex format.
+ */
+static void packColor(const math::Vec3& color, float alpha, uint8_t out[4]) {
+    out[0] = static_cast<uint8_t>(math::clamp(color.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+    out[1] = static_cast<uint8_t>(math::clamp(color.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+    out[2] = static_cast<uint8_t>(math::clamp(color.z, 0.0f, 1.0f) * 255.0f + 0.5f);
+    out[3] = static_cast<uint8_t>(math::clamp(alpha, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
 
-    return true;
+/**
+ * @brief Decode the UTF-8 sequence starting at text[i] and advance i past it.
+ *
+ * Malformed, overlong and surrogate sequences decode to U+FFFD and consume
+ * a single byte, so decoding always makes progress.
+ */
+static uint32_t decodeUtf8(const std::string& text, size_t& i) {
+    const uint32_t REPLACEMENT = 0xFFFD;
+    unsigned char lead = static_cast<unsigned char>(text[i++]);
+    if (lead < 0x80) return lead;
+
+    int length;
+    uint32_t codepoint;
+    uint32_t minimum;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 1; codepoint = lead & 0x1F; minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 2; codepoint = lead & 0x0F; minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 3; codepoint = lead & 0x07; minimum = 0x10000;
+    } else {
+        return REPLACEMENT;
+    }
+
+    if (text.size() - i < static_cast<size_t>(length)) return REPLACEMENT;
+    for (int k = 0; k < length; ++k) {
+        unsigned char next = static_cast<unsigned char>(text[i + k]);
+        if ((next & 0xC0) != 0x80) return REPLACEMENT;
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    if (codepoint < minimum || codepoint > 0x10FFFF ||
+        (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return REPLACEMENT;
+    }
+
+    i += length;
+    return codepoint;
 }
 
 void TextRenderer::renderText(const std::string& text, float x, float y, float scale,
-                               const math::Vec3& color, const math::Mat4& projection,
-                               float rotation, float alpha, bool centered) {
-    m_shader.use();
-    m_shader.setMat4("u_projection", projection.data());
-    m_shader.setVec3("u_textColor", color.x, color.y, color.z);
-    m_shader.setFloat("u_alpha", alpha);
-    m_shader.setInt("u_fontTexture", 0);
+                               const math::Vec3& color, float rotation, float alpha,
+                               bool centered) {
+    uint8_t rgba[4];
+    packColor(color, alpha, rgba);
 
-    // Create model matrix for rotation around the text position
-    math::Mat4 model = math::Mat4::translate(x, y, 0.0f) *
-                       math::Mat4::rotate(rotation) *
-                       math::Mat4::scale(scale, scale, 1.0f);
-    m_shader.setMat4("u_model", model.data());
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_fontTexture);
-    glBindVertexArray(m_vao);
+    // Rotation around the text position, applied to glyph quads on the CPU
+    math::Affine2 model = math::Affine2::translate(x, y) *
+                          math::Affine2::rotate(rotation) *
+                          math::Affine2::scale(scale, scale);
 
     // Calculate starting cursor position (centered if requested)
     float cursorX = 0;
     float cursorY = 0;
 
+    const TextLayout& run = layout(text);
+
     if (centered) {
-        // Calculate unscaled text width for centering (scale is in model matrix)
-        float textWidth = getTextWidth(text, 1.0f);
-        cursorX = -textWidth / 2.0f;
+        // Unscaled text width for centering (scale is in the model transform)
+        cursorX = -run.width / 2.0f;
         // Center vertically (approximate: baseline sits at fontSize/4 above center)
         cursorY = -m_fontSize / 4.0f;
     }
 
-    for (char c : text) {
-        auto it = m_glyphs.find(c);
-        if (it == m_glyphs.end()) continue;
+    for (size_t i = 0; i < run.codepoints.size(); ++i) {
+        const CachedGlyph* glyph = m_glyphCache.acquire(run.codepoints[i]);
+        if (!glyph) continue;
 
-        const GlyphInfo& g = it->second;
-
-        float xpos = cursorX + g.xoff;
+        const GlyphInfo& g = glyph->info;
+        float xpos = cursorX + run.offsets[i] + g.xoff;
         // Flip Y: stb_truetype uses Y-down, OpenGL uses Y-up
         // yoff is negative for glyphs above baseline, so negate it
         float ypos = cursorY - g.yoff - g.height;
 
-        float w = g.width;
-        float h = g.height;
-
-        // 6 vertices for a quad (2 triangles)
-        // ypos is bottom, ypos+h is top (OpenGL Y-up)
-        // Texture y0 is top of glyph, y1 is bottom
-        float vertices[] = {
-            xpos,     ypos,     g.x0, g.y1,  // bottom-left
-            xpos,     ypos + h, g.x0, g.y0,  // top-left
-            xpos + w, ypos + h, g.x1, g.y0,  // top-right
-
-            xpos,     ypos,     g.x0, g.y1,  // bottom-left
-            xpos + w, ypos + h, g.x1, g.y0,  // top-right
-            xpos + w, ypos,     g.x1, g.y1   // bottom-right
-        };
-
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        cursorX += g.xadvance;
+        appendGlyphQuad(*glyph, xpos, ypos, model, rgba);
     }
-
-    glBindVertexArray(0);
 }
 
 void TextRenderer::renderTextOnArc(const std::string& text, float radius, float centerAngle,
-                                    float scale, const math::Vec3& color, const math::Mat4& projection,
+                                    float scale, const math::Vec3& color,
                                     bool clockwise, float alpha) {
-    if (text.empty()) return;
+    queueTextOnArc(m_arcText, text, radius, centerAngle, scale, color, clockwise, alpha);
+}
 
-    m_shader.use();
-    m_shader.setMat4("u_projection", projection.data());
-    m_shader.setVec3("u_textColor", color.x, color.y, color.z);
-    m_shader.setFloat("u_alpha", alpha);
-    m_shader.setInt("u_fontTexture", 0);
+/**
+ * @brief Queue text curved along an arc.
+ *
+ * Records one instance per glyph (glyph cache slot and the unscaled advance
+ * before it) and the string's radius, start angle, scale, direction and
+ * color. text_arc.vert does the placement and rotation, so there is no
+ * per-glyph trigonometry or matrix work on the CPU.
+ */
+void TextRenderer::queueTextOnArc(ArcTextQueue& queue, const std::string& text, float radius,
+                                  float centerAngle, float scale, const math::Vec3& color,
+                                  bool clockwise, float alpha) {
+    if (text.empty()) return;
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_fontTexture);
-    glBindVertexArray(m_vao);
+    const TextLayout& run = layout(text);
+    for (size_t i = 0; i < run.codepoints.size(); ++i) {
+        const CachedGlyph* glyph = m_glyphCache.acquire(run.codepoints[i]);
+        if (!glyph) continue;
 
-    // Calculate total text width (unscaled)
-    float totalWidth = getTextWidth(text, 1.0f);
+        queue.glyphs.push_back(static_cast<float>(m_glyphCache.slotIndex(glyph)));
+        queue.glyphs.push_back(run.offsets[i]);
+    }
 
     // Convert width to angular span on the arc
     // Arc length = radius * angle, so angle = arc_length / radius
-    float angularSpan = (totalWidth * scale) / radius;
+    float angularSpan = (run.width * scale) / radius;
 
     // Direction multiplier (clockwise = negative angle change)
     float dir = clockwise ? -1.0f : 1.0f;
 
     // Start angle: offset by half the span to center the text
-    float currentAngle = centerAngle - dir * angularSpan / 2.0f;
-
-    for (char c : text) {
-        auto it = m_glyphs.find(c);
-        if (it == m_glyphs.end()) continue;
-
-        const GlyphInfo& g = it->second;
+    float startAngle = centerAngle - dir * angularSpan / 2.0f;
+
+    const float params[8] = {
+        radius, startAngle, scale, dir,
+        color.x, color.y, color.z, alpha
+    };
+    queue.strings.insert(queue.strings.end(), params, params + 8);
+    queue.stringEnds.push_back(queue.glyphs.size() / 2);
+}
 
-        // Character width in angular terms
-        float charAngularWidth = (g.xadvance * scale) / radius;
+void TextRenderer::submitTextOnArc(RenderGraph& graph, RenderPass pass, const std::string& text,
+                                   float radius, float centerAngle, float scale,
+                                   const math::Vec3& color, bool clockwise, float alpha) {
+    size_t index = m_submittedArcText.stringEnds.size();
+    queueTextOnArc(m_submittedArcText, text, radius, centerAngle, scale, color, clockwise, alpha);
+    if (m_submittedArcText.stringEnds.size() == index) return;
+
+    DrawState state;
+    state.program = m_arcShader.getProgram();
+    state.texture = m_glyphCache.getTexture();
+    graph.submit(pass, state, *this, static_cast<uint32_t>(index));
+}
 
-        // Position at center of this character
-        float charAngle = currentAngle + dir * charAngularWidth / 2.0f;
+void TextRenderer::drawBatch(const uint32_t* items, size_t count) {
+    m_glyphCache.upload();
+    if (m_glyphCache.takeSlotsChanged()) {
+        uploadGlyphTable();
+    }
+    drawArcStrings(m_submittedArcText, items, count);
+}
 
-        // Position on the arc
-        float x = radius * std::cos(charAngle);
-        float y = radius * std::sin(charAngle);
+void TextRenderer::clearSubmitted() {
+    m_submittedArcText.clear();
+}
 
-        // Rotation: tangent to arc (perpendicular to radius)
-        // For clockwise text, tangent points in direction of decreasing angle
-        float rotation = charAngle - math::PI / 2.0f;
-        if (!clockwise) {
-            rotation = charAngle + math::PI / 2.0f;
-        }
+/**
+ * @brief Append one glyph quad (two triangles) to the batch in world space.
+ *
+ * @param glyph Glyph to draw.
+ * @param xpos  Left edge of the quad in text space.
+ * @param ypos  Bottom edge of the quad in text space (OpenGL Y-up).
+ * @param model Text space to world space transform.
+ * @param color RGBA8 color for all six vertices.
+ */
+void TextRenderer::appendGlyphQuad(const CachedGlyph& glyph, float xpos, float ypos,
+                                   const math::Affine2& model, const uint8_t color[4]) {
+    const GlyphInfo& g = glyph.info;
+    float page = static_cast<float>(glyph.page);
+    float w = g.width;
+    float h = g.height;
+
+    // Corners: ypos is bottom, ypos+h is top (OpenGL Y-up)
+    // Texture y0 is top of glyph, y1 is bottom
+    math::Vec2 bl = model.transform(math::Vec2(xpos,     ypos));
+    math::Vec2 tl = model.transform(math::Vec2(xpos,     ypos + h));
+    math::Vec2 tr = model.transform(math::Vec2(xpos + w, ypos + h));
+    math::Vec2 br = model.transform(math::Vec2(xpos + w, ypos));
+
+    const TextVertex quad[6] = {
+        { bl.x, bl.y, g.x0, g.y1, page, { color[0], color[1], color[2], color[3] } },
+        { tl.x, tl.y, g.x0, g.y0, page, { color[0], color[1], color[2], color[3] } },
+        { tr.x, tr.y, g.x1, g.y0, page, { color[0], color[1], color[2], color[3] } },
+
+        { bl.x, bl.y, g.x0, g.y1, page, { color[0], color[1], color[2], color[3] } },
+        { tr.x, tr.y, g.x1, g.y0, page, { color[0], color[1], color[2], color[3] } },
+        { br.x, br.y, g.x1, g.y1, page, { color[0], color[1], color[2], color[3] } }
+    };
+    m_batch.insert(m_batch.end(), quad, quad + 6);
+}
 
-        // Create model matrix: translate to position, rotate, scale
-        math::Mat4 model = math::Mat4::translate(x, y, 0.0f) *
-                           math::Mat4::rotate(rotation) *
-                           math::Mat4::scale(scale, scale, 1.0f);
-        m_shader.setMat4("u_model", model.data());
+/**
+ * @brief Draw all queued text with one upload and one draw call.
+ *
+ * Glyphs are already in world space with per-vertex color and atlas page,
+ * so strings of any color, size or orientation share the batch. Glyphs
+ * rasterized since the last flush are uploaded first. Draws use the
+ * projection in the bound FrameGlobals block.
+ */
+void TextRenderer::flush() {
+    m_glyphCache.upload();
+    if (m_glyphCache.takeSlotsChanged()) {
+        uploadGlyphTable();
+    }
 
-        // Center the glyph at origin (so rotation is around center)
-        float halfW = g.width / 2.0f;
-        float halfH = g.height / 2.0f;
-        float yOffset = -m_fontSize / 4.0f;  // Baseline adjustment
+    flushArcText();
 
-        float xpos = -halfW + g.xoff;
-        float ypos = yOffset - g.yoff - g.height;
+    if (m_batch.empty()) return;
 
-        float w = g.width;
-        float h = g.height;
+    const GLsizei stride = sizeof(TextVertex);
+    GLintptr offset = m_stream->upload(m_batch.data(), m_batch.size() * stride, stride);
+    if (offset == StreamBuffer::UPLOAD_FAILED) {
+        m_batch.clear();
+        return;
+    }
 
-        // 6 vertices for a quad
-        float vertices[] = {
-            xpos,     ypos,     g.x0, g.y1,
-            xpos,     ypos + h, g.x0, g.y0,
-            xpos + w, ypos + h, g.x1, g.y0,
+    m_shader.use();
+    m_shader.setInt(m_sdfUniform, m_atlasMode == FontAtlasMode::Sdf ? 1 : 0);
 
-            xpos,     ypos,     g.x0, g.y1,
-            xpos + w, ypos + h, g.x1, g.y0,
-            xpos + w, ypos,     g.x1, g.y1
-        };
+    GLState::instance().activeTexture(GL_TEXTURE0);
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, m_glyphCache.getTexture());
+    GLState::instance().bindVertexArray(m_vao);
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    glDrawArrays(GL_TRIANGLES, static_cast<GLint>(offset / stride), static_cast<GLsizei>(m_batch.size()));
+    m_batch.clear();
+}
 
-        // Advance to next character position
-        currentAngle += dir * charAngularWidth;
+void TextRenderer::flushArcText() {
+    m_drawStrings.clear();
+    for (size_t i = 0; i < m_arcText.stringEnds.size(); ++i) {
+        m_drawStrings.push_back(static_cast<uint32_t>(i));
     }
+    drawArcStrings(m_arcText, m_drawStrings.data(), m_drawStrings.size());
+    m_arcText.clear();
+}
 
-    glBindVertexArray(0);
+void TextRenderer::ArcTextQueue::clear() {
+    glyphs.clear();
+    strings.clear();
+    stringEnds.clear();
 }
 
-float TextRenderer::getTextWidth(const std::string& text, float scale) const {
-    float width = 0;
-    for (char c : text) {
-        auto it = m_glyphs.find(c);
-        if (it != m_glyphs.end()) {
-            width += it->second.xadvance;
+/**
+ * @brief Draw queued curved strings as instanced glyph quads.
+ *
+ * The strings' glyph instances are gathered, tagged with their string's
+ * slot in u_strings, and uploaded once. Strings are drawn MAX_ARC_STRINGS
+ * at a time (the size of the u_strings array), so normally this is a
+ * single instanced draw.
+ *
+ * @param queue   Queue holding the strings.
+ * @param strings Indices of strings in queue, in draw order.
+ * @param count   Number of indices.
+ */
+void TextRenderer::drawArcStrings(const ArcTextQueue& queue, const uint32_t* strings, size_t count) {
+    m_drawGlyphs.clear();
+    m_drawParams.clear();
+    m_drawStringEnds.clear();
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t string = strings[i];
+        size_t begin = string > 0 ? queue.stringEnds[string - 1] : 0;
+        size_t end = queue.stringEnds[string];
+        float slot = static_cast<float>(i % MAX_ARC_STRINGS);
+        for (size_t glyph = begin; glyph < end; ++glyph) {
+            m_drawGlyphs.push_back(queue.glyphs[glyph * 2]);
+            m_drawGlyphs.push_back(queue.glyphs[glyph * 2 + 1]);
+            m_drawGlyphs.push_back(slot);
         }
+        m_drawParams.insert(m_drawParams.end(), &queue.strings[string * 8], &queue.strings[string * 8] + 8);
+        m_drawStringEnds.push_back(m_drawGlyphs.size() / 3);
+    }
+    if (m_drawGlyphs.empty()) return;
+
+    const GLsizei stride = 3 * sizeof(float);
+    GLintptr offset = m_stream->upload(m_drawGlyphs.data(), m_drawGlyphs.size() * sizeof(float), stride);
+    if (offset == StreamBuffer::UPLOAD_FAILED) return;
+
+    m_arcShader.use();
+    m_arcShader.setInt(m_arcSdfUniform, m_atlasMode == FontAtlasMode::Sdf ? 1 : 0);
+
+    GLState::instance().activeTexture(GL_TEXTURE0);
+    GLState::instance().bindTexture(GL_TEXTURE_2D_ARRAY, m_glyphCache.getTexture());
+    GLState::instance().bindBufferBase(GL_UNIFORM_BUFFER, GLYPH_TABLE_BINDING, m_glyphTableUbo);
+    GLState::instance().bindVertexArray(m_arcVao);
+    GLState::instance().bindBuffer(GL_ARRAY_BUFFER, m_stream->getBuffer());
+
+    size_t firstGlyph = 0;
+    for (size_t first = 0; first < count; first += MAX_ARC_STRINGS) {
+        size_t chunk = std::min(count - first, static_cast<size_t>(MAX_ARC_STRINGS));
+        size_t endGlyph = m_drawStringEnds[first + chunk - 1];
+        if (endGlyph == firstGlyph) continue;
+
+        m_arcShader.setVec4Array(m_stringsUniform, &m_drawParams[first * 8], static_cast<int>(chunk * 2));
+
+        // Instance layout: glyph index, advance, string slot
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + firstGlyph * stride));
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(endGlyph - firstGlyph));
+
+        firstGlyph = endGlyph;
     }
-    return width * scale;
 }
 
-float TextRenderer::getTextHeight(const std::string& text, float scale) const {
-    float height = 0;
-    for (char c : text) {
-        auto it = m_glyphs.find(c);
-        if (it != m_glyphs.end()) {
-            height = std::max(height, it->second.height);
+float TextRenderer::getTextWidth(const std::string& text, float scale) {
+    return layout(text).width * scale;
+}
+
+float TextRenderer::getTextHeight(const std::string& text, float scale) {
+    return layout(text).height * scale;
+}
+
+/**
+ * @brief Shape a string once and memoize the result.
+ *
+ * Clock labels change at most once a second, so each distinct string is
+ * decoded from UTF-8 and walked through the glyph cache only the first time
+ * it is seen; drawing it afterwards costs one cache lookup per glyph however
+ * complex the script. The cache
+ * is dropped wholesale if it grows past MAX_CACHED_LAYOUTS. Layouts keep
+ * codepoints rather than cache slots, so they stay valid when glyphs are
+ * evicted. A layout missing a glyph only because the glyph cache was full
+ * is returned but not memoized.
+ *
+ * @param text The string to lay out.
+ * @return Unscaled width, height and per-glyph pen positions.
+ */
+const TextLayout& TextRenderer::layout(const std::string& text) {
+    auto it = m_layouts.find(text);
+    if (it != m_layouts.end()) {
+        return it->second;
+    }
+
+    if (m_layouts.size() >= MAX_CACHED_LAYOUTS) {
+        m_layouts.clear();
+    }
+
+    TextLayout run;
+    bool complete = true;
+    for (size_t i = 0; i < text.size();) {
+        uint32_t codepoint = decodeUtf8(text, i);
+        const CachedGlyph* glyph = m_glyphCache.acquire(codepoint);
+        if (!glyph) {
+            complete = complete && m_glyphCache.isMissing(codepoint);
+            continue;
         }
+
+        run.codepoints.push_back(codepoint);
+        run.offsets.push_back(run.width);
+        run.width += glyph->info.xadvance;
+        run.height = std::max(run.height, glyph->info.inkHeight);
+    }
+
+    if (!complete) {
+        m_partialLayout = std::move(run);
+        return m_partialLayout;
     }
-    return height * scale;
+    return m_layouts.emplace(text, std::move(run)).first->second;
 }
 
 } // namespace polarclock
@@ -1,50 +1,147 @@
 #pragma once
 
 #include "shader.h"
+#include "stream_buffer.h"
+#include "glyph_cache.h"
+#include "render_graph.h"
 #include "pcmath.h"
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
 
 namespace polarclock {
 
-struct GlyphInfo {
-    float x0, y0, x1, y1;  // Texture coordinates
-    float xoff, yoff;       // Offset from cursor
-    float xadvance;         // Advance to next character
-    float width, height;    // Glyph dimensions
+// Shaped run of a string at the font's native size, memoized by TextRenderer::layout()
+struct TextLayout {
+    float width = 0.0f;                // Sum of glyph advances
+    float height = 0.0f;               // Tallest glyph
+    std::vector<uint32_t> codepoints;  // Each drawn glyph
+    std::vector<float> offsets;        // Pen position before each drawn glyph
 };
 
-class TextRenderer {
+// Batched glyph vertex: world-space position, atlas UV and page, RGBA8 color
+struct TextVertex {
+    float x, y;
+    float u, v, page;
+    uint8_t color[4];
+};
+
+class TextRenderer : public DrawBatcher {
 public:
     TextRenderer();
     ~TextRenderer();
 
-    bool init(const std::string& fontPath, float fontSize);
+    // Submit the text programs and load the font; call waitForPrograms()
+    // before drawing
+    bool init(const std::string& fontPath, float fontSize, StreamBuffer& stream);
+    void pollPrograms();
+    bool waitForPrograms();
+
+    // Queue text for drawing; nothing reaches the GPU until flush()
     void renderText(const std::string& text, float x, float y, float scale,
-                    const math::Vec3& color, const math::Mat4& projection,
-                    float rotation = 0.0f, float alpha = 1.0f, bool centered = false);
+                    const math::Vec3& color, float rotation = 0.0f,
+                    float alpha = 1.0f, bool centered = false);
 
-    // Render text curved along an arc
+    // Queue text curved along an arc. Glyphs are placed on the GPU, so the
+    // CPU only records glyph indices and advances.
     // centerAngle: angle where text should be centered (radians)
     // radius: distance from origin to place text
     // clockwise: if true, text curves clockwise from centerAngle
     void renderTextOnArc(const std::string& text, float radius, float centerAngle,
-                         float scale, const math::Vec3& color, const math::Mat4& projection,
+                         float scale, const math::Vec3& color,
+                         bool clockwise = true, float alpha = 1.0f);
+
+    // Queue curved text as a packet in `graph` instead of for flush(). These
+    // strings have their own queue, so flush() neither draws nor clears them.
+    void submitTextOnArc(RenderGraph& graph, RenderPass pass, const std::string& text,
+                         float radius, float centerAngle, float scale, const math::Vec3& color,
                          bool clockwise = true, float alpha = 1.0f);
+    void drawBatch(const uint32_t* items, size_t count) override;
+    void clearSubmitted() override;
 
-    float getTextWidth(const std::string& text, float scale) const;
-    float getTextHeight(const std::string& text, float scale) const;
+    // Draw everything queued since the last flush: one draw for straight text,
+    // one instanced draw per MAX_ARC_STRINGS curved strings
+    void flush();
+
+    // Call once per frame after all text is drawn; glyphs used before this
+    // may be evicted afterwards
+    void endFrame() { m_glyphCache.endFrame(); }
+
+    // Switch to the atlas for another mode; layout metrics are unchanged
+    bool setAtlasMode(FontAtlasMode mode);
+    FontAtlasMode getAtlasMode() const { return m_atlasMode; }
+
+    float getFontSize() const { return m_fontSize; }
+    float getTextWidth(const std::string& text, float scale);
+    float getTextHeight(const std::string& text, float scale);
+
+    // Cached layout of a UTF-8 string; valid until the next call. Rasterizes
+    // any glyphs not yet in the glyph cache.
+    const TextLayout& layout(const std::string& text);
 
 private:
+    void appendGlyphQuad(const CachedGlyph& g, float xpos, float ypos,
+                         const math::Affine2& model, const uint8_t color[4]);
+    bool loadAtlas();
+    void uploadGlyphTable();
+    bool initArcText();
+    // Curved strings waiting to be drawn
+    struct ArcTextQueue {
+        std::vector<float> glyphs;       // Per glyph: table slot, advance before it
+        std::vector<float> strings;      // Per string: radius, start angle, scale, direction, RGBA
+        std::vector<size_t> stringEnds;  // Glyph count after each string
+
+        void clear();
+    };
+
+    void queueTextOnArc(ArcTextQueue& queue, const std::string& text, float radius, float centerAngle,
+                        float scale, const math::Vec3& color, bool clockwise, float alpha);
+    void flushArcText();
+    void drawArcStrings(const ArcTextQueue& queue, const uint32_t* strings, size_t count);
+
+    StreamBuffer* m_stream;  // Shared per-frame vertex storage, owned by Renderer
+
     Shader m_shader;
+    int m_sdfUniform;  // Handle of text.frag's u_sdf
     GLuint m_vao;
-    GLuint m_vbo;
-    GLuint m_fontTexture;
 
-    std::unordered_map<char, GlyphInfo> m_glyphs;
+    std::vector<TextVertex> m_batch;  // Queued glyph quads, cleared by flush()
+
+    // Curved text: instanced unit quads laid out by text_arc.vert
+    Shader m_arcShader;
+    int m_arcSdfUniform;   // Handles of u_sdf and u_strings in the arc program
+    int m_stringsUniform;
+    GLuint m_arcVao;
+    GLuint m_cornerVbo;
+    GLuint m_glyphTableUbo;
+    ArcTextQueue m_arcText;           // From renderTextOnArc(), cleared by flush()
+    ArcTextQueue m_submittedArcText;  // From submitTextOnArc(), cleared by clearSubmitted()
+
+    // The strings being drawn, gathered from one of the queues above
+    std::vector<uint32_t> m_drawStrings;
+    std::vector<float> m_drawGlyphs;  // Per glyph: table slot, advance before it, string slot
+    std::vector<float> m_drawParams;
+    std::vector<size_t> m_drawStringEnds;
+
+    std::string m_fontPath;
+    std::vector<unsigned char> m_fontData;  // TTF bytes for glyphs missing from the baked atlas
+    FontAtlasMode m_atlasMode;
+
+    GlyphCache m_glyphCache;
+
+    std::unordered_map<std::string, TextLayout> m_layouts;
+    TextLayout m_partialLayout;  // Layout missing glyphs the cache had no room for; not memoized
     float m_fontSize;
-    int m_atlasWidth;
-    int m_atlasHeight;
+
+    // Must match text_arc.vert
+    static constexpr int MAX_ARC_STRINGS = 32;
+    static constexpr int GLYPH_TABLE_SIZE = GlyphCache::MAX_GLYPHS;
+    static constexpr GLuint GLYPH_TABLE_BINDING = 0;
+
+    // Distinct strings kept in m_layouts before it is cleared. Clock labels
+    // cycle through a few hundred values at most.
+    static constexpr size_t MAX_CACHED_LAYOUTS = 512;
 };
 
 } // namespace polarclock
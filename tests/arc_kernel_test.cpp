@@ -0,0 +1,121 @@
+// Compares arc meshes converted by the compiled-in polarToCartesian backend
+// with the scalar std::cos / std::sin path the renderer used before it.
+// Built once per backend (see CMakeLists.txt); exits with 77 (skipped) when
+// the machine cannot run the backend it was built for.
+
+#include "arc_kernel.h"
+#include "pcmath.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace polarclock;
+
+namespace {
+
+// Largest allowed position error, in world units (rings span about 1 unit)
+constexpr double MAX_ERROR = 1e-5;
+
+constexpr int SKIPPED = 77;
+
+// Previous ArcRenderer::encodeVertices: one double-precision cos/sin per vertex
+void convertScalar(const std::vector<PolarVertex>& vertices, std::vector<float>& out) {
+    out.clear();
+    for (const PolarVertex& v : vertices) {
+        double angle = v.angle;
+        out.push_back(static_cast<float>(v.radius * std::cos(angle)));
+        out.push_back(static_cast<float>(v.radius * std::sin(angle)));
+    }
+}
+
+// Largest coordinate difference between the backend and the scalar path
+double compare(const std::vector<PolarVertex>& vertices) {
+    std::vector<float> expected;
+    convertScalar(vertices, expected);
+
+    std::vector<float> actual(vertices.size() * 2);
+    polarToCartesian(vertices.data(), actual.data(), vertices.size());
+
+    double maxError = 0.0;
+    for (size_t i = 0; i < actual.size(); ++i) {
+        maxError = std::max(maxError, std::abs(static_cast<double>(actual[i]) - expected[i]));
+    }
+    return maxError;
+}
+
+bool backendSupported() {
+#if defined(__AVX2__) && defined(__FMA__) && defined(__GNUC__) && !defined(POLARCLOCK_ARC_KERNEL_SCALAR)
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return true;
+#endif
+}
+
+struct RingSize {
+    double innerRadius;
+    double outerRadius;
+};
+
+} // namespace
+
+int main() {
+    if (!backendSupported()) {
+        std::cout << "Skipping " << arcKernelBackend() << ": not supported by this CPU" << std::endl;
+        return SKIPPED;
+    }
+
+    // The clock's rings in world units, plus a thin and a thick ring
+    const RingSize rings[] = {
+        { 0.229, 0.351 }, { 0.366, 0.488 }, { 0.503, 0.625 }, { 0.640, 0.763 }, { 0.778, 0.900 },
+        { 0.50, 0.51 }, { 0.05, 0.95 }
+    };
+    const double sweeps[] = { 0.0015, 0.01, 0.1, 0.25, 0.333, 0.5, 0.75, 0.999, 1.0 };
+    const int circleSegments[] = { 16, 17, 128, 333, 1024 };
+    const int endcapSegments[] = { 2, 3, 7, 12 };
+
+    double worstArc = 0.0;
+    size_t arcs = 0;
+    std::vector<PolarVertex> vertices;
+    for (const RingSize& ring : rings) {
+        for (double sweep : sweeps) {
+            for (int circle : circleSegments) {
+                for (int endcap : endcapSegments) {
+                    generateArcGeometry(ring.innerRadius, ring.outerRadius, sweep, circle, endcap, vertices);
+                    if (vertices.empty()) {
+                        std::cerr << "No geometry for sweep " << sweep << std::endl;
+                        return 1;
+                    }
+                    worstArc = std::max(worstArc, compare(vertices));
+                    ++arcs;
+                }
+            }
+        }
+    }
+
+    // Endcaps on their own, at both ends of the angle range the arcs use
+    const double endcapStarts[] = { math::PI / 2.0, 0.0, -math::PI, -1.5 * math::PI + 0.1 };
+    double worstEndcap = 0.0;
+    for (const RingSize& ring : rings) {
+        double cr = (ring.outerRadius - ring.innerRadius) * 0.1;
+        double endcapSize = std::atan(cr / ring.innerRadius);
+        for (double start : endcapStarts) {
+            for (int endcap : endcapSegments) {
+                vertices.clear();
+                generateEndcap(vertices, ring.innerRadius, ring.outerRadius, cr,
+                               start, endcapSize, start, endcap, 0, endcap);
+                worstEndcap = std::max(worstEndcap, compare(vertices));
+            }
+        }
+    }
+
+    std::cout << arcKernelBackend() << ": " << arcs << " arcs, max error " << worstArc
+              << "; endcaps, max error " << worstEndcap << std::endl;
+
+    if (worstArc > MAX_ERROR || worstEndcap > MAX_ERROR) {
+        std::cerr << arcKernelBackend() << " deviates from the scalar path by more than "
+                  << MAX_ERROR << std::endl;
+        return 1;
+    }
+    return 0;
+}
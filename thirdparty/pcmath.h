@@ -1,9 +1,124 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define PCMATH_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PCMATH_NEON
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define PCMATH_WASM_SIMD
+#endif
 
 namespace math {
 
+// Polynomial sincos, after Cephes sinf/cosf. The argument is reduced by pi/2
+// with a three-part Cody-Waite split and both functions are evaluated with
+// minimax polynomials on [-pi/4, pi/4]. Exposed so vectorized
+// implementations can use the same coefficients.
+namespace sincos_poly {
+constexpr float TWO_OVER_PI = 0.636619772367581343f;
+constexpr float PIO2_1 = 1.5703125f;
+constexpr float PIO2_2 = 4.837512969970703125e-4f;
+constexpr float PIO2_3 = 7.54978995489188216e-8f;
+constexpr float SIN_C1 = -1.6666654611e-1f;
+constexpr float SIN_C2 = 8.3321608736e-3f;
+constexpr float SIN_C3 = -1.9515295891e-4f;
+constexpr float COS_C1 = 4.166664568298827e-2f;
+constexpr float COS_C2 = -1.388731625493765e-3f;
+constexpr float COS_C3 = 2.443315711809948e-5f;
+} // namespace sincos_poly
+
+// Sine and cosine of x in one call, without libm.
+// Max absolute error is 1e-7 for |x| <= 1e4; larger arguments lose accuracy
+// in the range reduction (1e-6 at 1e5).
+inline void fastSinCos(float x, float& s, float& c) {
+    using namespace sincos_poly;
+    // Quadrant: odd quadrants swap sin and cos, sin is negated in quadrants
+    // 2 and 3, cos in quadrants 1 and 2
+    int q = static_cast<int>(std::floor(x * TWO_OVER_PI + 0.5f));
+    float k = static_cast<float>(q);
+    float r = x - k * PIO2_1 - k * PIO2_2 - k * PIO2_3;
+    float r2 = r * r;
+
+    float ps = r + r * r2 * (SIN_C1 + r2 * (SIN_C2 + r2 * SIN_C3));
+    float pc = 1.0f - 0.5f * r2 + r2 * r2 * (COS_C1 + r2 * (COS_C2 + r2 * COS_C3));
+
+    float sv = (q & 1) ? pc : ps;
+    float cv = (q & 1) ? ps : pc;
+    s = (q & 2) ? -sv : sv;
+    c = ((q + 1) & 2) ? -cv : cv;
+}
+
+// Compile-time sin/cos of k * TAU / N for k in [0, N), e.g. one entry per
+// arc segment. Use through sinCosTable<N>.
+template <int N>
+struct SinCosTable {
+    float sines[N];
+    float cosines[N];
+
+    constexpr SinCosTable() : sines(), cosines() {
+        const double pi = 3.14159265358979323846;
+        for (int k = 0; k < N; ++k) {
+            // Fold into [-pi/4, pi/4] by eighths of a turn so the Taylor
+            // series below converges to double precision
+            double turn = static_cast<double>(k) / N;
+            int q = static_cast<int>(turn * 4.0 + 0.5);
+            double r = (turn * 4.0 - q) * (pi / 2.0);
+            double r2 = r * r;
+
+            double s = 0.0, c = 0.0;
+            double sTerm = r, cTerm = 1.0;
+            for (int i = 1; i <= 10; ++i) {
+                s += sTerm;
+                c += cTerm;
+                sTerm *= -r2 / ((2 * i) * (2 * i + 1));
+                cTerm *= -r2 / ((2 * i - 1) * (2 * i));
+            }
+
+            double sv = (q & 1) ? c : s;
+            double cv = (q & 1) ? s : c;
+            sines[k] = static_cast<float>((q & 2) ? -sv : sv);
+            cosines[k] = static_cast<float>(((q + 1) & 2) ? -cv : cv);
+        }
+    }
+};
+
+template <int N>
+inline constexpr SinCosTable<N> sinCosTable{};
+
+// Walks angles start, start + step, start + 2 step, ... by rotating the
+// current (cos, sin) pair, so each step costs a few multiplies instead of a
+// sincos. The pair is renormalized every step to stop magnitude drift;
+// the remaining error is under 1e-6 after 1000 steps.
+class AngleStepper {
+public:
+    AngleStepper(float start, float step) {
+        fastSinCos(start, m_sin, m_cos);
+        fastSinCos(step, m_stepSin, m_stepCos);
+    }
+
+    float cos() const { return m_cos; }
+    float sin() const { return m_sin; }
+
+    void advance() {
+        float c = m_cos * m_stepCos - m_sin * m_stepSin;
+        float s = m_sin * m_stepCos + m_cos * m_stepSin;
+        // One Newton step towards unit length
+        float k = 1.5f - 0.5f * (c * c + s * s);
+        m_cos = c * k;
+        m_sin = s * k;
+    }
+
+private:
+    float m_cos, m_sin;
+    float m_stepCos, m_stepSin;
+};
+
 struct Vec2 {
     float x, y;
 
@@ -72,8 +187,8 @@ struct Mat4 {
 
     static Mat4 rotate(float angle) { // 2D rotation around Z
         Mat4 result;
-        float c = std::cos(angle);
-        float s = std::sin(angle);
+        float c, s;
+        fastSinCos(angle, s, c);
         result.m[0] = c;
         result.m[1] = s;
         result.m[4] = -s;
@@ -89,22 +204,132 @@ struct Mat4 {
         return result;
     }
 
+    // Column j of the product is this matrix's columns weighted by column j
+    // of other, computed four rows at a time where SIMD is available
     Mat4 operator*(const Mat4& other) const {
         Mat4 result;
-        for (int i = 0; i < 16; ++i) result.m[i] = 0;
+#if defined(PCMATH_SSE)
+        __m128 c0 = _mm_loadu_ps(m);
+        __m128 c1 = _mm_loadu_ps(m + 4);
+        __m128 c2 = _mm_loadu_ps(m + 8);
+        __m128 c3 = _mm_loadu_ps(m + 12);
+        for (int col = 0; col < 4; ++col) {
+            const float* b = other.m + col * 4;
+            __m128 r = _mm_mul_ps(c0, _mm_set1_ps(b[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(b[1])));
+            r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(b[2])));
+            r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(b[3])));
+            _mm_storeu_ps(result.m + col * 4, r);
+        }
+#elif defined(PCMATH_NEON)
+        float32x4_t c0 = vld1q_f32(m);
+        float32x4_t c1 = vld1q_f32(m + 4);
+        float32x4_t c2 = vld1q_f32(m + 8);
+        float32x4_t c3 = vld1q_f32(m + 12);
+        for (int col = 0; col < 4; ++col) {
+            float32x4_t b = vld1q_f32(other.m + col * 4);
+            float32x4_t r = vmulq_lane_f32(c0, vget_low_f32(b), 0);
+            r = vmlaq_lane_f32(r, c1, vget_low_f32(b), 1);
+            r = vmlaq_lane_f32(r, c2, vget_high_f32(b), 0);
+            r = vmlaq_lane_f32(r, c3, vget_high_f32(b), 1);
+            vst1q_f32(result.m + col * 4, r);
+        }
+#elif defined(PCMATH_WASM_SIMD)
+        v128_t c0 = wasm_v128_load(m);
+        v128_t c1 = wasm_v128_load(m + 4);
+        v128_t c2 = wasm_v128_load(m + 8);
+        v128_t c3 = wasm_v128_load(m + 12);
+        for (int col = 0; col < 4; ++col) {
+            const float* b = other.m + col * 4;
+            v128_t r = wasm_f32x4_mul(c0, wasm_f32x4_splat(b[0]));
+            r = wasm_f32x4_add(r, wasm_f32x4_mul(c1, wasm_f32x4_splat(b[1])));
+            r = wasm_f32x4_add(r, wasm_f32x4_mul(c2, wasm_f32x4_splat(b[2])));
+            r = wasm_f32x4_add(r, wasm_f32x4_mul(c3, wasm_f32x4_splat(b[3])));
+            wasm_v128_store(result.m + col * 4, r);
+        }
+#else
         for (int col = 0; col < 4; ++col) {
             for (int row = 0; row < 4; ++row) {
+                float sum = 0;
                 for (int k = 0; k < 4; ++k) {
-                    result.m[col * 4 + row] += m[k * 4 + row] * other.m[col * 4 + k];
+                    sum += m[k * 4 + row] * other.m[col * 4 + k];
                 }
+                result.m[col * 4 + row] = sum;
             }
         }
+#endif
         return result;
     }
 
     const float* data() const { return m; }
 };
 
+// 2D affine transform (2x3, column-major): x' = a x + c y + tx, y' = b x + d y + ty.
+// Covers translate/rotate/scale in the plane at a fraction of the cost of a
+// Mat4, for per-glyph and per-sprite transforms.
+struct Affine2 {
+    float a, b, c, d, tx, ty;
+
+    Affine2() : a(1), b(0), c(0), d(1), tx(0), ty(0) {}
+    Affine2(float a, float b, float c, float d, float tx, float ty)
+        : a(a), b(b), c(c), d(d), tx(tx), ty(ty) {}
+
+    static Affine2 translate(float x, float y) {
+        return Affine2(1, 0, 0, 1, x, y);
+    }
+
+    static Affine2 rotate(float angle) {
+        float c, s;
+        fastSinCos(angle, s, c);
+        return rotate(c, s);
+    }
+
+    // Rotation from a precomputed cosine and sine
+    static Affine2 rotate(float cosAngle, float sinAngle) {
+        return Affine2(cosAngle, sinAngle, -sinAngle, cosAngle, 0, 0);
+    }
+
+    static Affine2 scale(float sx, float sy) {
+        return Affine2(sx, 0, 0, sy, 0, 0);
+    }
+
+    // Composition: (A * B) applies B first, then A
+    Affine2 operator*(const Affine2& o) const {
+        return Affine2(a * o.a + c * o.b,
+                       b * o.a + d * o.b,
+                       a * o.c + c * o.d,
+                       b * o.c + d * o.d,
+                       a * o.tx + c * o.ty + tx,
+                       b * o.tx + d * o.ty + ty);
+    }
+
+    Vec2 transform(const Vec2& p) const {
+        return Vec2(a * p.x + c * p.y + tx, b * p.x + d * p.y + ty);
+    }
+
+    // Transform count points in place. Each point is the first two floats
+    // of a vertex that is stride floats long (e.g. position + texcoord).
+    void transformPoints(float* vertices, size_t count, size_t stride) const {
+        for (size_t i = 0; i < count; ++i, vertices += stride) {
+            float x = vertices[0];
+            float y = vertices[1];
+            vertices[0] = a * x + c * y + tx;
+            vertices[1] = b * x + d * y + ty;
+        }
+    }
+
+    Mat4 toMat4() const {
+        Mat4 result;
+        result.m[0] = a;
+        result.m[1] = b;
+        result.m[4] = c;
+        result.m[5] = d;
+        result.m[12] = tx;
+        result.m[13] = ty;
+        return result;
+    }
+};
+
 // Utility functions
 constexpr float PI = 3.14159265358979323846f;
 constexpr float TAU = 2.0f * PI;
@@ -0,0 +1,73 @@
+# Generate a C++ header embedding every GLSL source in SHADER_DIR.
+#
+# Usage: cmake -DSHADER_DIR=<dir> -DOUTPUT=<header> -P embed_shaders.cmake
+#
+# Each *.vert, *.frag and *.glsl file becomes an EmbeddedShader enumerator
+# (arc_sdf.vert -> ArcSdfVert) and an entry of EMBEDDED_SHADERS holding its
+# file name and source as a raw string literal. *.glsl files are shared
+# snippets rather than whole stages. The header is only rewritten when its
+# contents change, so unrelated edits do not rebuild everything.
+
+if(NOT SHADER_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "embed_shaders.cmake needs SHADER_DIR and OUTPUT")
+endif()
+
+file(GLOB SHADER_FILES ${SHADER_DIR}/*.vert ${SHADER_DIR}/*.frag ${SHADER_DIR}/*.glsl)
+list(SORT SHADER_FILES)
+
+set(ENUMERATORS "")
+set(ENTRIES "")
+foreach(SHADER_FILE ${SHADER_FILES})
+    get_filename_component(NAME ${SHADER_FILE} NAME)
+
+    # arc_sdf.vert -> ArcSdfVert
+    string(REPLACE "." "_" WORDS ${NAME})
+    string(REPLACE "_" ";" WORDS ${WORDS})
+    set(ENUMERATOR "")
+    foreach(WORD ${WORDS})
+        string(SUBSTRING ${WORD} 0 1 FIRST)
+        string(SUBSTRING ${WORD} 1 -1 REST)
+        string(TOUPPER ${FIRST} FIRST)
+        string(APPEND ENUMERATOR ${FIRST}${REST})
+    endforeach()
+
+    file(READ ${SHADER_FILE} SOURCE)
+    string(FIND "${SOURCE}" ")glsl\"" CLASH)
+    if(NOT CLASH EQUAL -1)
+        message(FATAL_ERROR "${NAME} contains the raw string delimiter )glsl\"")
+    endif()
+
+    string(APPEND ENUMERATORS "    ${ENUMERATOR},\n")
+    string(APPEND ENTRIES "    { \"${NAME}\", R\"glsl(${SOURCE})glsl\" },\n")
+endforeach()
+
+set(HEADER "// Generated by tools/embed_shaders.cmake from shaders/. Do not edit.
+#pragma once
+
+#include <string_view>
+
+namespace polarclock {
+
+enum class EmbeddedShader {
+${ENUMERATORS}    Count
+};
+
+struct EmbeddedShaderSource {
+    std::string_view name;    // File name within shaders/
+    std::string_view source;
+};
+
+// Indexed by EmbeddedShader
+inline constexpr EmbeddedShaderSource EMBEDDED_SHADERS[] = {
+${ENTRIES}};
+
+} // namespace polarclock
+")
+
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} PREVIOUS)
+    if(PREVIOUS STREQUAL HEADER)
+        return()
+    endif()
+endif()
+file(WRITE ${OUTPUT} "${HEADER}")
@@ -0,0 +1,63 @@
+// polarclock-fontbake: bake a font atlas at build time so the runtime can
+// upload it directly instead of rasterizing the TTF on every launch.
+//
+// Usage: polarclock-fontbake <font.ttf> <font size> <bitmap|sdf> <output.pcfa>
+
+#include "font_atlas.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace polarclock;
+
+int main(int argc, char** argv) {
+    if (argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " <font.ttf> <font size> <bitmap|sdf> <output.pcfa>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Failed to open font file: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<unsigned char> fontData((std::istreambuf_iterator<char>(input)),
+                                        std::istreambuf_iterator<char>());
+
+    float fontSize = static_cast<float>(std::atof(argv[2]));
+    if (fontSize <= 0.0f) {
+        std::cerr << "Invalid font size: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    FontAtlasMode mode;
+    if (std::strcmp(argv[3], "bitmap") == 0) {
+        mode = FontAtlasMode::Bitmap;
+    } else if (std::strcmp(argv[3], "sdf") == 0) {
+        mode = FontAtlasMode::Sdf;
+    } else {
+        std::cerr << "Unknown atlas mode: " << argv[3] << std::endl;
+        return 1;
+    }
+
+    FontAtlas atlas;
+    if (!bakeFontAtlas(fontData, fontSize, mode, atlas)) {
+        return 1;
+    }
+
+    std::vector<unsigned char> blob;
+    writeFontAtlas(atlas, blob);
+
+    std::ofstream output(argv[4], std::ios::binary);
+    output.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+    if (!output.good()) {
+        std::cerr << "Failed to write " << argv[4] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Baked " << atlas.glyphs.size() << " glyphs into " << argv[4]
+              << " (" << atlas.width << "x" << atlas.height << ", " << blob.size() << " bytes)" << std::endl;
+    return 0;
+}